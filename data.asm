@@ -16,4 +16,16 @@ sprites_simple_pal:
 .incbin "assets/graphics/sprites/sprites_simple.pal"
 sprites_simple_pal_end:
 
+collision_room0:
+.incbin "assets/maps/room0.col"
+collision_room0_end:
+
+dialogbank:
+.incbin "assets/text/dialog.bin"
+dialogbank_end:
+
+sfxbank:
+.incbin "assets/audio/sfx_bank.bin"
+sfxbank_end:
+
 .ends
\ No newline at end of file
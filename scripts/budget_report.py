@@ -0,0 +1,283 @@
+#!/usr/bin/env python3
+"""WRAM / ROM / VRAM budget report for the linked ROM.
+
+Reads the wlalink .sym file, the captured linker output (.map), the
+compiler listings (src/*.ps.01.dbg) and budget.cfg, prints per-symbol and
+per-section usage, and exits 1 when a configured ceiling is exceeded.
+The bank $7F arena's high-water mark is runtime data: it is taken from the
+last perf run (build/perf_results.txt, written by make perf) when that run
+is newer than the .sym, i.e. measured on this link.
+
+    python3 scripts/budget_report.py build/ChronicEchos.sym build/ChronicEchos.map
+
+WRAM symbol sizes are exact for globals declared in src/*.h (layouts from
+gen_lua_layouts.py) and the distance to the next label otherwise.
+"""
+
+import argparse
+import glob
+import os
+import re
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import dbg_listing          # noqa: E402
+import gen_lua_layouts      # noqa: E402
+
+LABEL_LINE = re.compile(r"^([0-9a-fA-F]{2}):?([0-9a-fA-F]{4})\s+(\S+)$")
+BANK_LINE = re.compile(r"bank\s+\$?([0-9a-fA-F]+)\b(.*)", re.I)
+FREE_BYTES = re.compile(r"(\d+)\s+bytes(?:\s*\([^)]*\))?\s+free", re.I)
+LOROM_BANK_SIZE = 0x8000
+
+
+def parse_number(text):
+    return int(text, 0)
+
+
+def read_config(path):
+    limits = {}
+    vram = []
+    arena = None
+    with open(path, "r", encoding="utf-8") as config:
+        for raw in config:
+            line = raw.split("#", 1)[0].strip()
+            if not line:
+                continue
+            fields = line.split()
+            if fields[0] == "limit" and len(fields) == 3:
+                limits[fields[1]] = parse_number(fields[2])
+            elif fields[0] == "vram" and len(fields) == 4:
+                vram.append((fields[1], parse_number(fields[2]), fields[3]))
+            elif fields[0] == "arena" and len(fields) == 3:
+                arena = (parse_number(fields[1]), parse_number(fields[2]))
+            else:
+                raise ValueError("%s: bad line '%s'" % (path, raw.strip()))
+    return limits, vram, arena
+
+
+def read_labels(path):
+    labels = []
+    section = None
+    with open(path, "r", encoding="utf-8", errors="replace") as sym:
+        for raw in sym:
+            line = raw.strip()
+            if line.startswith("["):
+                section = line.lower()
+                continue
+            match = LABEL_LINE.match(line)
+            if section == "[labels]" and match:
+                bank, addr, name = match.groups()
+                labels.append((int(bank, 16), int(addr, 16), name))
+    return labels
+
+
+def wram_symbols(labels, layouts):
+    """(bank, address, name, size, exact) for labels in $7E/$7F or low-RAM mirrors."""
+    wram = []
+    for bank, addr, name in labels:
+        if bank in (0x7E, 0x7F):
+            wram.append((bank, addr, name))
+        elif bank < 0x40 and addr < 0x2000:
+            wram.append((0x7E, addr, name))
+    wram.sort()
+
+    result = []
+    for i, (bank, addr, name) in enumerate(wram):
+        exact = name in layouts.globals
+        if exact:
+            type_name, count = layouts.globals[name]
+            size = layouts.structs[type_name][0] * max(count, 1) if type_name in layouts.structs \
+                else gen_lua_layouts.PRIMITIVES[type_name][0] * max(count, 1)
+        elif i + 1 < len(wram) and wram[i + 1][0] == bank and (wram[i + 1][1] < 0x2000) == (addr < 0x2000):
+            # Same bank and same side of the low RAM boundary
+            size = wram[i + 1][1] - addr
+        else:
+            size = 0
+        result.append((bank, addr, name, size, exact))
+    return result
+
+
+def rom_usage(labels, map_path):
+    """Bytes used per ROM bank: from the linker's free-space report when
+    available, else estimated from the highest label in each bank."""
+    used = {}
+    source = "estimated from .sym"
+    if map_path and os.path.exists(map_path):
+        with open(map_path, "r", encoding="utf-8", errors="replace") as linker:
+            for line in linker:
+                bank = BANK_LINE.search(line)
+                free = FREE_BYTES.search(line)
+                if bank and free:
+                    used[int(bank.group(1), 16)] = LOROM_BANK_SIZE - int(free.group(1))
+        if used:
+            source = "linker output"
+
+    if not used:
+        for bank, addr, _ in labels:
+            if bank < 0x7E and addr >= 0x8000:
+                used[bank] = max(used.get(bank, 0), addr - 0x8000 + 1)
+    return used, source
+
+
+def asset_sizes(labels):
+    """ROM data blobs delimited by `name:` / `name_end:` label pairs."""
+    address = {name: (bank << 16) | addr for bank, addr, name in labels}
+    assets = []
+    for name, start in address.items():
+        end = address.get(name + "_end")
+        if end is not None and end >= start:
+            assets.append((name, start, end - start))
+    return sorted(assets, key=lambda asset: -asset[2])
+
+
+def arena_usage(path):
+    """Worst arena.high_water and total arena.failures over the scenarios of a
+    perf run ("<scenario> <metric> <value>" lines), or None if not measured."""
+    if not path or not os.path.exists(path):
+        return None
+    high_water = None
+    failures = 0
+    with open(path, "r", encoding="utf-8") as results:
+        for line in results:
+            fields = line.split()
+            if len(fields) != 3:
+                continue
+            if fields[1] == "arena.high_water":
+                high_water = max(high_water or 0, int(fields[2]))
+            elif fields[1] == "arena.failures":
+                failures += int(fields[2])
+    return None if high_water is None else (high_water, failures)
+
+
+def vram_regions(entries, root):
+    regions = []
+    for name, word_address, source in entries:
+        if re.match(r"^(0x)?[0-9a-fA-F]+$", source):
+            size = parse_number(source)
+        else:
+            path = os.path.join(root, source)
+            size = os.path.getsize(path) if os.path.exists(path) else None
+        regions.append((name, word_address, size, source))
+    return regions
+
+
+def main(argv):
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("sym")
+    parser.add_argument("map", nargs="?")
+    parser.add_argument("--config", default="budget.cfg")
+    parser.add_argument("--src", default="src")
+    parser.add_argument("--dbg", default="src/*.ps.01.dbg")
+    parser.add_argument("--top", type=int, default=12)
+    parser.add_argument("--perf", help="perf results with arena metrics (default: perf_results.txt next to the .sym)")
+    args = parser.parse_args(argv[1:])
+
+    limits, vram_entries, arena = read_config(args.config)
+    labels = read_labels(args.sym)
+    layouts = gen_lua_layouts.load(args.src)
+    failures = []
+
+    def check(metric, value, label):
+        limit = limits.get(metric)
+        mark = ""
+        if limit is not None:
+            mark = "  (limit %d, %.0f%%)" % (limit, value * 100.0 / limit)
+            if value > limit:
+                failures.append("%s: %d bytes exceeds %s limit %d" % (label, value, metric, limit))
+                mark += "  OVER"
+        return mark
+
+    # WRAM: the low 8 KB of $7E (mirrored into every system bank) is its own region
+    print("== WRAM ==")
+    symbols = wram_symbols(labels, layouts)
+    regions = (("low RAM", "wram.low", lambda bank, addr: bank == 0x7E and addr < 0x2000),
+               ("bank $7E", "wram.7e", lambda bank, addr: bank == 0x7E and addr >= 0x2000),
+               ("bank $7F", "wram.7f", lambda bank, addr: bank == 0x7F))
+    for name, metric, contains in regions:
+        in_region = [s for s in symbols if contains(s[0], s[1])]
+        total = sum(s[3] for s in in_region)
+        print("%-9s %d bytes in %d symbols%s" % (name + ":", total, len(in_region),
+                                                 check(metric, total, "WRAM " + name)))
+    print("%-28s %10s %8s" % ("symbol", "address", "bytes"))
+    for bank, addr, name, size, exact in sorted(symbols, key=lambda s: -s[3])[:args.top]:
+        print("%-28s   $%02X:%04X %8d%s" % (name, bank, addr, size, "" if exact else " ~"))
+    print("(~ = distance to the next label)")
+
+    # Bank $7F arena (reserved range; usage is measured at runtime)
+    if arena:
+        base, size = arena
+        print("\n== Arena ==")
+        print("region: $7F:%04X-$7F:%04X %d bytes" % (base, base + size - 1, size))
+        for bank, addr, name, _, _ in symbols:
+            if bank == 0x7F and base <= addr < base + size:
+                failures.append("arena: linked symbol %s at $7F:%04X is inside the arena" % (name, addr))
+        perf_path = args.perf or os.path.join(os.path.dirname(os.path.abspath(args.sym)), "perf_results.txt")
+        usage = arena_usage(perf_path)
+        if usage is not None and os.path.getmtime(perf_path) < os.path.getmtime(args.sym):
+            # Measured on an older ROM: neither pass nor fail this link on it
+            print("high water: stale (%s predates this link; run make perf)" % perf_path)
+        elif usage is None:
+            print("high water: not measured (run make perf)")
+        else:
+            high_water, refused = usage
+            print("high water: %d bytes (%.0f%%) from %s%s" % (high_water, high_water * 100.0 / size, perf_path,
+                                                              check("arena.high_water", high_water, "Arena")))
+            if refused:
+                failures.append("arena: %d allocation(s) refused during the perf run" % refused)
+
+    # ROM
+    print("\n== ROM ==")
+    used, source = rom_usage(labels, args.map)
+    for bank in sorted(used):
+        print("bank $%02X: %6d / %d bytes%s" % (bank, used[bank], LOROM_BANK_SIZE,
+                                               check("rom.bank", used[bank], "ROM bank $%02X" % bank)))
+    total = sum(used.values())
+    print("total:    %6d bytes (%s)%s" % (total, source, check("rom.total", total, "ROM")))
+    assets = asset_sizes(labels)
+    if assets:
+        print("%-28s %10s %8s" % ("asset", "address", "bytes"))
+        for name, start, size in assets[:args.top]:
+            print("%-28s   $%02X:%04X %8d" % (name, start >> 16, start & 0xFFFF, size))
+
+    # VRAM (word addresses, sizes in bytes)
+    print("\n== VRAM ==")
+    regions = vram_regions(vram_entries, os.path.dirname(os.path.abspath(args.config)))
+    vram_total = 0
+    spans = []
+    for name, word_address, size, source in regions:
+        if size is None:
+            print("%-16s $%04X   ?      (%s not built)" % (name, word_address, source))
+            continue
+        vram_total += size
+        spans.append((word_address, word_address + (size + 1) // 2, name))
+        print("%-16s $%04X-$%04X %6d bytes  %s" % (name, word_address, word_address + (size + 1) // 2 - 1,
+                                                   size, source))
+    spans.sort()
+    for (start_a, end_a, name_a), (start_b, _, name_b) in zip(spans, spans[1:]):
+        if start_b < end_a:
+            failures.append("VRAM: %s overlaps %s at $%04X" % (name_a, name_b, start_b))
+    print("total: %d bytes%s" % (vram_total, check("vram.total", vram_total, "VRAM")))
+
+    # Code size
+    print("\n== Largest functions (estimated bytes) ==")
+    functions = []
+    for path in sorted(glob.glob(args.dbg)):
+        functions.extend(dbg_listing.parse_listing(path))
+    functions.sort(key=lambda function: -function.size)
+    for function in functions[:args.top]:
+        print("%-36s %6d  %s%s" % (function.name, function.size, os.path.basename(function.source),
+                                   check("function.max", function.size, "function %s" % function.name)))
+    for function in functions[args.top:]:
+        check("function.max", function.size, "function %s" % function.name)
+
+    if failures:
+        print("\nBudget exceeded:")
+        for failure in failures:
+            print("  " + failure)
+        return 1
+    print("\nAll budgets within limits")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
@@ -0,0 +1,577 @@
+#!/usr/bin/env python3
+"""Static cycle estimates for the compiler listings.
+
+Splits every function in src/*.ctf.03.dbg (the listing that is assembled)
+into basic blocks, finds its loops, and estimates the worst-case cost of
+one call and of each loop from 65816 instruction timings: program bytes
+are fetched at ROM speed (SlowROM 8 / FastROM 6 master clocks), data
+accesses go to WRAM (8) and internal operations take 6. Register widths
+follow sep/rep. Calls add the callee's estimate when it is in a listing,
+otherwise the cost given in cycles.cfg (or nothing, and the callee is
+listed as unknown).
+
+Trip counts come from the loop itself when the header compares a counter
+against an immediate and the body steps it by a constant; cycles.cfg can
+give the rest. Nothing here runs the ROM, so figures are estimates for
+ranking and for catching codegen regressions between builds:
+
+    python3 scripts/cycle_estimate.py                 # report
+    python3 scripts/cycle_estimate.py --baseline tests/perf/cycles_baseline.txt
+    python3 scripts/cycle_estimate.py --baseline ... --update
+"""
+
+import argparse
+import glob
+import math
+import os
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import dbg_listing          # noqa: E402
+
+MASTER_CLOCKS_PER_LINE = 1364
+WRAM_CLOCKS = 8
+IO_CLOCKS = 6
+
+INDEX_OPS = {"ldx", "ldy", "stx", "sty", "cpx", "cpy"}
+RMW_OPS = {"inc", "dec", "asl", "lsr", "rol", "ror", "tsb", "trb"}
+RETURNS = {"rts", "rtl", "rti"}
+CONDITIONAL = dbg_listing.BRANCHES - {"bra"}
+# Stack ops: (internal cycles, data bytes; None = register width)
+PUSHES = {"pha": (1, None), "phx": (1, None), "phy": (1, None), "php": (1, 1),
+          "phb": (1, 1), "phk": (1, 1), "phd": (1, 2)}
+PULLS = {"pla": (2, None), "plx": (2, None), "ply": (2, None), "plp": (2, 1),
+         "plb": (2, 1), "pld": (2, 2)}
+
+
+class Cost:
+    """CPU cycles split by bus speed; converted to master clocks at the end."""
+
+    def __init__(self, fetch=0, data=0, io=0):
+        self.fetch = fetch
+        self.data = data
+        self.io = io
+
+    def __add__(self, other):
+        return Cost(self.fetch + other.fetch, self.data + other.data, self.io + other.io)
+
+    def master_clocks(self, rom_clocks):
+        return self.fetch * rom_clocks + self.data * WRAM_CLOCKS + self.io * IO_CLOCKS
+
+
+def instruction_cost(instruction):
+    """Cost of one instruction, branches counted as not taken."""
+    mnemonic = instruction.mnemonic
+    operand = instruction.operand
+    fetch = instruction.size
+    accu_width = 2 if instruction.accu16 else 1
+    index_width = 2 if instruction.index16 else 1
+
+    if mnemonic in dbg_listing.BRANCHES:
+        return Cost(fetch, 0, 1 if mnemonic == "bra" else 0)
+    if mnemonic == "brl":
+        return Cost(fetch, 0, 1)
+    if mnemonic in ("jmp", "jml"):
+        return Cost(fetch, 0, 0)
+    if mnemonic == "jsr":
+        return Cost(fetch, 3 if instruction.suffix == "l" else 2, 1)
+    if mnemonic == "rtl":
+        return Cost(fetch, 3, 2)
+    if mnemonic in ("rts", "rti"):
+        return Cost(fetch, 2 if mnemonic == "rts" else 4, 3 if mnemonic == "rts" else 2)
+    if mnemonic in ("sep", "rep"):
+        return Cost(fetch, 0, 1)
+    if mnemonic == "pea":
+        return Cost(fetch, 2, 0)
+    if mnemonic == "pei":
+        return Cost(fetch, 4, 0)
+    if mnemonic == "per":
+        return Cost(fetch, 2, 1)
+    if mnemonic in ("mvn", "mvp"):
+        return Cost(fetch, 2, 2)            # Per byte moved
+    if mnemonic in PUSHES or mnemonic in PULLS:
+        io, data = PUSHES.get(mnemonic) or PULLS[mnemonic]
+        if data is None:
+            data = index_width if mnemonic[-1] in "xy" else accu_width
+        return Cost(fetch, data, io)
+    if mnemonic == "xba":
+        return Cost(fetch, 0, 2)
+    if not operand or operand in ("a", "A"):
+        return Cost(fetch, 0, 1)            # Implied and accumulator modes
+    if operand.startswith("#"):
+        return Cost(fetch, 0, 0)
+
+    width = index_width if mnemonic in INDEX_OPS else accu_width
+    data = width
+    io = 0
+    if mnemonic in RMW_OPS:
+        data = 2 * width
+        io = 1
+    if operand.startswith("["):
+        data += 3                           # Long pointer from direct page
+    elif operand.startswith("("):
+        data += 2
+        if operand.endswith(",s),y"):
+            io += 2
+    elif operand.endswith(",s"):
+        io += 1
+    elif instruction.suffix != "l" and operand.endswith((",x", ",y")):
+        io += 1 if instruction.index16 else 0
+    return Cost(fetch, data, io)
+
+
+#---------------------------------------------------------------------------------
+# Basic blocks
+
+class Block:
+    def __init__(self, index):
+        self.index = index
+        self.labels = []
+        self.instructions = []
+        self.successors = []    # (block index, taken branch)
+
+    def cost(self):
+        total = Cost()
+        for instruction in self.instructions:
+            total = total + instruction_cost(instruction)
+        return total
+
+    @property
+    def name(self):
+        named = [label for label in self.labels if label[0] not in "+-"]
+        return named[0] if named else "block%d" % self.index
+
+
+def ends_block(instruction):
+    return (instruction.mnemonic in dbg_listing.BRANCHES or instruction.mnemonic in RETURNS or
+            instruction.mnemonic in ("brl", "jml") or
+            (instruction.mnemonic == "jmp" and not instruction.operand.startswith("(")))
+
+
+def build_blocks(function):
+    blocks = [Block(0)]
+    positions = []              # (label, block index) in listing order
+    for item in function.items:
+        current = blocks[-1]
+        if isinstance(item, tuple):
+            if current.instructions:
+                current = Block(len(blocks))
+                blocks.append(current)
+            current.labels.append(item[1])
+            positions.append((item[1], current.index))
+            continue
+        current.instructions.append(item)
+        if ends_block(item):
+            blocks.append(Block(len(blocks)))
+    if not blocks[-1].instructions and not blocks[-1].labels:
+        blocks.pop()
+
+    def resolve(label, block_index):
+        if label and label[0] == "+":
+            for name, index in positions:
+                if name == label and index > block_index:
+                    return index
+        elif label and label[0] == "-":
+            for name, index in reversed(positions):
+                if name == label and index <= block_index:
+                    return index
+        else:
+            for name, index in positions:
+                if name == label:
+                    return index
+        return None
+
+    for block in blocks:
+        last = block.instructions[-1] if block.instructions else None
+        falls_through = True
+        if last and ends_block(last):
+            if last.mnemonic in RETURNS:
+                falls_through = False
+            else:
+                target = resolve(last.operand.split(",")[0].strip(), block.index)
+                if target is not None:
+                    block.successors.append((target, last.mnemonic in CONDITIONAL))
+                falls_through = last.mnemonic in CONDITIONAL
+        if falls_through and block.index + 1 < len(blocks):
+            block.successors.append((block.index + 1, False))
+    return blocks
+
+
+def dominators(blocks):
+    # Dead code (a `bra` after a `bra`) must not take part, or it hides loops
+    reachable = {0}
+    stack = [0]
+    while stack:
+        for target, _ in blocks[stack.pop()].successors:
+            if target not in reachable:
+                reachable.add(target)
+                stack.append(target)
+    predecessors = {block.index: set() for block in blocks}
+    for block in blocks:
+        for target, _ in block.successors:
+            if block.index in reachable:
+                predecessors[target].add(block.index)
+    everything = reachable
+    dom = {index: set(everything) for index in everything}
+    dom[0] = {0}
+    changed = True
+    while changed:
+        changed = False
+        for index in sorted(everything - {0}):
+            preds = [dom[p] for p in predecessors[index]]
+            new = (set.intersection(*preds) if preds else set()) | {index}
+            if new != dom[index]:
+                dom[index] = new
+                changed = True
+    return dom, predecessors
+
+
+class Loop:
+    def __init__(self, header):
+        self.header = header
+        self.body = {header}
+        self.latches = set()
+        self.trips = None
+        self.exact = False      # Trip count derived from the code
+        self.iteration = 0      # Master clocks per trip
+        self.calls = 0          # Calls per entry, counting inner loops
+
+
+def find_loops(blocks):
+    dom, predecessors = dominators(blocks)
+    loops = {}
+    for block in blocks:
+        for target, _ in block.successors:
+            if block.index in dom and target in dom[block.index]:
+                loop = loops.setdefault(target, Loop(target))
+                loop.latches.add(block.index)
+                stack = [block.index]
+                while stack:
+                    node = stack.pop()
+                    if node not in loop.body:
+                        loop.body.add(node)
+                        stack.extend(predecessors[node])
+    return sorted(loops.values(), key=lambda loop: loop.header), predecessors
+
+
+def counter_trips(loop, blocks, predecessors):
+    """Trip count of a `for (i = a; i < N; i += step)` loop, or None."""
+    header = blocks[loop.header].instructions
+    loads = [i.operand for i in header if i.mnemonic == "lda" and i.operand.endswith(",s")]
+    bounds = [i.operand for i in header
+              if i.mnemonic in ("sbc", "cmp") and i.operand.startswith("#")]
+    if not loads or not bounds:
+        return None
+    slot = loads[0]
+    bound = parse_immediate(bounds[0])
+
+    step = None
+    for index in loop.body:
+        pending = None
+        for instruction in blocks[index].instructions:
+            mnemonic = instruction.mnemonic
+            if mnemonic == "inc":
+                pending = 1
+            elif mnemonic == "dec":
+                pending = -1
+            elif mnemonic in ("adc", "sbc") and instruction.operand.startswith("#"):
+                value = parse_immediate(instruction.operand)
+                pending = value if mnemonic == "adc" else -value
+            elif mnemonic == "sta" and instruction.operand == slot and pending is not None:
+                step = pending
+    start = 0
+    for index in predecessors[loop.header] - loop.body:
+        accumulator = None
+        memory = {}
+        for instruction in blocks[index].instructions:
+            if instruction.mnemonic == "stz":
+                memory[instruction.operand] = 0
+            elif instruction.mnemonic == "lda":
+                accumulator = (parse_immediate(instruction.operand)
+                               if instruction.operand.startswith("#")
+                               else memory.get(instruction.operand))
+            elif instruction.mnemonic == "sta" and instruction.operand == slot:
+                start = accumulator if accumulator is not None else start
+    if bound is None or not step or step < 0 or bound <= start:
+        return None
+    return int(math.ceil((bound - start) / float(step)))
+
+
+def parse_immediate(operand):
+    text = operand.lstrip("#").strip()
+    try:
+        return int(text[1:], 16) if text.startswith("$") else int(text, 0)
+    except ValueError:
+        return None
+
+
+#---------------------------------------------------------------------------------
+# Estimates
+
+class Estimator:
+    def __init__(self, functions, rom_clocks, call_costs, trip_hints):
+        self.functions = {function.name: function for function in functions}
+        self.rom_clocks = rom_clocks
+        self.call_costs = call_costs
+        self.trip_hints = trip_hints
+        self.results = {}
+        self.active = set()
+        self.unknown = {}       # Callee -> callers
+
+    def call_cost(self, caller, callee):
+        if callee in self.call_costs:
+            return self.call_costs[callee]
+        if callee in self.functions and callee not in self.active:
+            return self.estimate(callee)["clocks"]
+        self.unknown.setdefault(callee, set()).add(caller)
+        return 0
+
+    def block_clocks(self, name, block):
+        clocks = block.cost().master_clocks(self.rom_clocks)
+        calls = 0
+        for instruction in block.instructions:
+            if instruction.mnemonic == "jsr":
+                clocks += self.call_cost(name, instruction.operand)
+                calls += 1
+        return clocks, calls
+
+    def region(self, name, blocks, entry, body, inner, costs):
+        """Longest path from 'entry' through 'body' to an exit or back to 'entry',
+        with each loop in 'inner' collapsed into one node."""
+        owner = {}
+        for loop in inner:
+            for index in loop.body:
+                owner[index] = loop
+        memo = {}
+
+        def node_cost(node):
+            if node in owner and owner[node].header == node:
+                loop = owner[node]
+                return loop.trips * loop.iteration + costs[node][0], loop.trips * loop.calls
+            return costs[node]
+
+        def exits(node):
+            members = owner[node].body if node in owner else {node}
+            for member in members:
+                for target, taken in blocks[member].successors:
+                    if target in members:
+                        continue
+                    extra = IO_CLOCKS if taken else 0
+                    if target not in body or target == entry:
+                        yield None, extra
+                    else:
+                        yield owner[target].header if target in owner else target, extra
+
+        def longest(node, visiting):
+            if node in memo:
+                return memo[node]
+            clocks, calls = node_cost(node)
+            best = (0, 0)
+            visiting = visiting | {node}
+            for target, extra in exits(node):
+                if target is None or target in visiting:
+                    tail = (extra, 0)
+                else:
+                    follow = longest(target, visiting)
+                    tail = (follow[0] + extra, follow[1])
+                best = max(best, tail)
+            memo[node] = (clocks + best[0], calls + best[1])
+            return memo[node]
+
+        return longest(entry, frozenset())
+
+    def estimate(self, name):
+        if name in self.results:
+            return self.results[name]
+        self.active.add(name)
+        function = self.functions[name]
+        blocks = build_blocks(function)
+        loops, predecessors = find_loops(blocks)
+        costs = {block.index: self.block_clocks(name, block) for block in blocks}
+
+        def inner_loops(outer):
+            nested = [loop for loop in loops if loop is not outer and loop.body <= outer.body]
+            return [loop for loop in nested
+                    if not any(other is not loop and loop.body < other.body for other in nested)]
+
+        # Innermost first, so nested loops are costed before their parents
+        for loop in sorted(loops, key=lambda loop: len(loop.body)):
+            loop.trips = counter_trips(loop, blocks, predecessors)
+            loop.exact = loop.trips is not None
+            if loop.trips is None:
+                loop.trips = self.trip_hints.get(name, 1)
+            loop.iteration, loop.calls = self.region(name, blocks, loop.header, loop.body,
+                                                     inner_loops(loop), costs)
+
+        everything = set(range(len(blocks)))
+        top = [loop for loop in loops
+               if not any(other is not loop and loop.body < other.body for other in loops)]
+        clocks, calls = self.region(name, blocks, 0, everything, top, costs)
+        reloads = 0
+        for block in blocks:
+            for first, second in zip(block.instructions, block.instructions[1:]):
+                if (first.mnemonic in ("sta", "stz") and second.mnemonic == "lda" and
+                        first.operand == second.operand and first.accu16 == second.accu16):
+                    reloads += 1
+
+        self.active.discard(name)
+        self.results[name] = {
+            "name": name, "clocks": clocks, "calls": calls, "size": function.size,
+            "blocks": len(blocks), "loops": [(loop, blocks[loop.header].name) for loop in loops],
+            "reloads": reloads,
+        }
+        return self.results[name]
+
+
+def read_config(path):
+    call_costs = {}
+    trip_hints = {}
+    if not path or not os.path.exists(path):
+        return call_costs, trip_hints
+    with open(path, "r", encoding="utf-8") as config:
+        for raw in config:
+            line = raw.split("#", 1)[0].strip()
+            if not line:
+                continue
+            fields = line.split()
+            if fields[0] == "call" and len(fields) == 3:
+                call_costs[fields[1]] = int(fields[2], 0)
+            elif fields[0] == "trips" and len(fields) == 3:
+                trip_hints[fields[1]] = int(fields[2], 0)
+            else:
+                raise ValueError("%s: bad line '%s'" % (path, raw.strip()))
+    return call_costs, trip_hints
+
+
+#---------------------------------------------------------------------------------
+# Report and baseline
+
+def lines(clocks):
+    return clocks / float(MASTER_CLOCKS_PER_LINE)
+
+
+def report(results, top, rom_label, unknown):
+    print("== Cycle estimates (%s, master clocks; %d per scanline) ==" %
+          (rom_label, MASTER_CLOCKS_PER_LINE))
+
+    loops = []
+    for result in results:
+        for loop, label in result["loops"]:
+            loops.append((loop.trips * loop.iteration, result["name"], label, loop))
+    loops.sort(key=lambda entry: -entry[0])
+    print("Costliest loops (per entry, worst path):")
+    print("  %-32s %-12s %7s %9s %10s %7s %6s" %
+          ("function", "header", "trips", "per trip", "total", "lines", "calls"))
+    for total, name, label, loop in loops[:top]:
+        trips = ("%d" if loop.exact else "%d?") % loop.trips
+        print("  %-32s %-12s %7s %9d %10d %7.1f %6d" %
+              (name, label, trips, loop.iteration, total, lines(total), loop.trips * loop.calls))
+
+    print("Costliest functions (one call, worst path):")
+    print("  %-32s %10s %7s %6s %6s %6s %8s" %
+          ("function", "clocks", "lines", "bytes", "blocks", "loops", "reloads"))
+    for result in sorted(results, key=lambda result: -result["clocks"])[:top]:
+        print("  %-32s %10d %7.1f %6d %6d %6d %8d" %
+              (result["name"], result["clocks"], lines(result["clocks"]), result["size"],
+               result["blocks"], len(result["loops"]), result["reloads"]))
+
+    print("Totals: %d functions, %d loops, %d store-then-reload pairs" %
+          (len(results), len(loops), sum(result["reloads"] for result in results)))
+    if unknown:
+        print("Calls not costed (outside the listings; add 'call' lines to cycles.cfg):")
+        for callee in sorted(unknown):
+            print("  %-32s from %s" % (callee, ", ".join(sorted(unknown[callee]))))
+    print("'?' trip counts are unknown: 1 unless cycles.cfg gives 'trips'")
+
+
+def baseline_metrics(results):
+    metrics = {}
+    for result in results:
+        metrics[(result["name"], "clocks")] = result["clocks"]
+        worst = max([loop.trips * loop.iteration for loop, _ in result["loops"]] or [0])
+        if worst:
+            metrics[(result["name"], "loop_max")] = worst
+    return metrics
+
+
+def compare(metrics, path, threshold, min_delta):
+    base = {}
+    with open(path, "r", encoding="utf-8") as baseline:
+        for raw in baseline:
+            fields = raw.split()
+            if raw.startswith("#") or len(fields) != 3:
+                continue
+            base[(fields[0], fields[1])] = int(fields[2])
+    if not base:
+        # Every estimate would be NEW: nothing would be compared
+        print("Error: no estimates in %s. Record them with 'make cycles-baseline'." % path)
+        return 1
+
+    regressions = 0
+    print("Against %s:" % path)
+    for key in sorted(metrics):
+        label = "%s %s" % key
+        if key not in base:
+            print("  NEW   %-48s %10d" % (label, metrics[key]))
+            continue
+        old = base[key]
+        delta = metrics[key] - old
+        pct = delta * 100.0 / old if old > 0 else 0
+        if delta > min_delta and pct > threshold:
+            print("  SLOW  %-48s %10d -> %10d (+%.1f%%)" % (label, old, metrics[key], pct))
+            regressions += 1
+        elif delta < -min_delta and pct < -threshold:
+            print("  FAST  %-48s %10d -> %10d (%.1f%%)" % (label, old, metrics[key], pct))
+    for key in sorted(set(base) - set(metrics)):
+        print("  GONE  %s %s" % key)
+    if regressions:
+        print("%d estimate(s) grew by more than %s%%" % (regressions, threshold))
+        return 1
+    print("Estimates within threshold")
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("listings", nargs="*", help="listings (default src/*.<stage>.dbg)")
+    parser.add_argument("--stage", default="ctf.03", help="listing stage (ps.01, opt.02, ctf.03)")
+    parser.add_argument("--fastrom", action="store_true", help="6 master clocks per ROM byte")
+    parser.add_argument("--config", default="cycles.cfg", help="call costs and trip counts")
+    parser.add_argument("--top", type=int, default=10, help="rows per table")
+    parser.add_argument("--baseline", help="compare against (or --update) this file")
+    parser.add_argument("--update", action="store_true", help="rewrite the baseline")
+    parser.add_argument("--threshold", type=float, default=10, help="allowed growth in percent")
+    parser.add_argument("--min-delta", type=int, default=200, help="ignore growth below this")
+    args = parser.parse_args()
+
+    paths = args.listings or sorted(glob.glob("src/*.%s.dbg" % args.stage))
+    if not paths:
+        print("Error: no listings found (build the ROM first)")
+        return 1
+    functions = []
+    for path in paths:
+        functions.extend(dbg_listing.parse_listing(path))
+
+    call_costs, trip_hints = read_config(args.config)
+    estimator = Estimator(functions, 6 if args.fastrom else 8, call_costs, trip_hints)
+    results = [estimator.estimate(function.name) for function in functions]
+    report(results, args.top, "FastROM" if args.fastrom else "SlowROM", estimator.unknown)
+
+    if not args.baseline:
+        return 0
+    metrics = baseline_metrics(results)
+    if args.update:
+        with open(args.baseline, "w", encoding="utf-8") as baseline:
+            baseline.write("# function metric master-clocks - regenerate with: make cycles-baseline\n")
+            for key in sorted(metrics):
+                baseline.write("%s %s %d\n" % (key[0], key[1], metrics[key]))
+        print("Baseline updated: %s (%d metrics)" % (args.baseline, len(metrics)))
+        return 0
+    if not os.path.exists(args.baseline):
+        print("Error: %s missing. Run 'make cycles-baseline' first." % args.baseline)
+        return 1
+    return compare(metrics, args.baseline, args.threshold, args.min_delta)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,163 @@
+"""Parse the 816-tcc assembly listings (src/*.ps.01.dbg) into functions.
+
+Each C function is emitted as its own `.SECTION ".<name>text_..."` block:
+the label inside it is the function, and everything up to `.ENDS` is its
+code. Instruction sizes are estimated from the mnemonic, the operand
+syntax and the tracked register widths (sep/rep #$20 and #$10), which is
+exact for the subset of 65816 the compiler emits. `.ifgr` blocks (the
+stack frame setup, emitted only when a function has locals) are resolved
+against the listing's own `.define`s.
+"""
+
+import re
+
+SECTION = re.compile(r'^\.SECTION\s+"\.(\w+)text_0x[0-9a-fA-F]+"')
+LABEL = re.compile(r"^([A-Za-z_][\w.{}]*|\++|-+):\s*$")
+ANONYMOUS_LABEL = re.compile(r"^(\++|-+)(?:\s+(\S.*))?$")   # "+", "++ ", "+ dex"
+DEFINE = re.compile(r"^\.define\s+(\S+)\s+(-?\d+)\s*$")
+IFGR = re.compile(r"^\.ifgr\s+(\S+)\s+(-?\d+)\s*$")
+
+BRANCHES = {"bcc", "bcs", "beq", "bmi", "bne", "bpl", "bra", "bvc", "bvs"}
+INDEX_IMMEDIATE = {"ldx", "ldy", "cpx", "cpy"}
+IMPLIED_TWO_BYTE = {"rep", "sep", "cop", "brk", "wdm"}
+
+
+class Instruction:
+    def __init__(self, mnemonic, suffix, operand, accu16, line, index16=True):
+        self.mnemonic = mnemonic
+        self.suffix = suffix
+        self.operand = operand
+        self.accu16 = accu16
+        self.index16 = index16
+        self.line = line
+        self.size = instruction_size(mnemonic, suffix, operand, accu16, index16)
+
+    def __repr__(self):
+        return "%s%s %s" % (self.mnemonic, "." + self.suffix if self.suffix else "", self.operand)
+
+
+class Function:
+    def __init__(self, name, source):
+        self.name = name
+        self.source = source
+        self.items = []   # Instruction or ("label", name)
+
+    @property
+    def instructions(self):
+        return [item for item in self.items if isinstance(item, Instruction)]
+
+    @property
+    def size(self):
+        return sum(instruction.size for instruction in self.instructions)
+
+
+def instruction_size(mnemonic, suffix, operand, accu16, index16=True):
+    if mnemonic in BRANCHES:
+        return 2
+    if mnemonic in ("brl", "per"):
+        return 3
+    if mnemonic in ("mvn", "mvp"):
+        return 3
+    if mnemonic == "jml" or (mnemonic in ("jsr", "jmp") and suffix == "l"):
+        return 4
+    if mnemonic in IMPLIED_TWO_BYTE:
+        return 2
+    if mnemonic == "pea":
+        return 3
+    if mnemonic == "pei":
+        return 2
+    if not operand:
+        return 1
+    if operand.startswith("#"):
+        if mnemonic in INDEX_IMMEDIATE:
+            return 3 if index16 else 2
+        return 3 if accu16 else 2
+    if suffix == "b":
+        return 2
+    if suffix == "w":
+        return 3
+    if suffix == "l":
+        return 4
+    if operand.endswith(",s") or operand.startswith("(") or operand.startswith("["):
+        return 2
+    if operand in ("a", "A"):
+        return 1
+    return 3  # Absolute by default
+
+
+def status_bits(operand):
+    """Value of a sep/rep operand such as #$20."""
+    match = re.match(r"#\$([0-9a-fA-F]+)", operand)
+    return int(match.group(1), 16) if match else 0
+
+
+def parse_instruction(text, accu16, index16=True):
+    parts = text.split(None, 1)
+    opcode = parts[0].lower()
+    operand = parts[1].strip() if len(parts) > 1 else ""
+    if ";" in operand:
+        operand = operand.split(";", 1)[0].strip()
+    mnemonic, _, suffix = opcode.partition(".")
+    return Instruction(mnemonic, suffix, operand, accu16, text, index16)
+
+
+def parse_listing(path):
+    """Return the functions in one .dbg listing, in file order."""
+    functions = []
+    current = None
+    accu16 = True
+    index16 = True
+    defines = {}
+    conditions = []     # One bool per open .ifgr
+    with open(path, "r", encoding="utf-8", errors="replace") as listing:
+        for raw in listing:
+            line = raw.strip()
+            if not line or line.startswith(";"):
+                continue
+            define = DEFINE.match(line)
+            if define:
+                defines[define.group(1)] = int(define.group(2))
+                continue
+            ifgr = IFGR.match(line)
+            if ifgr:
+                conditions.append(defines.get(ifgr.group(1), 0) > int(ifgr.group(2)))
+                continue
+            if line.startswith(".else") and conditions:
+                conditions[-1] = not conditions[-1]
+                continue
+            if line.startswith(".endif") and conditions:
+                conditions.pop()
+                continue
+            if not all(conditions):
+                continue
+            section = SECTION.match(line)
+            if section:
+                current = Function(section.group(1), path)
+                functions.append(current)
+                accu16 = True
+                index16 = True
+                continue
+            if line.startswith(".ENDS"):
+                current = None
+                continue
+            if current is None or line.startswith("."):
+                continue
+            label = LABEL.match(line)
+            if label:
+                current.items.append(("label", label.group(1)))
+                continue
+            anonymous = ANONYMOUS_LABEL.match(line)
+            if anonymous:
+                current.items.append(("label", anonymous.group(1)))
+                if not anonymous.group(2):
+                    continue
+                line = anonymous.group(2)
+            instruction = parse_instruction(line, accu16, index16)
+            if instruction.mnemonic in ("sep", "rep"):
+                bits = status_bits(instruction.operand)
+                if bits & 0x20:
+                    accu16 = instruction.mnemonic == "rep"
+                if bits & 0x10:
+                    index16 = instruction.mnemonic == "rep"
+            current.items.append(instruction)
+    return functions
@@ -0,0 +1,98 @@
+#!/usr/bin/env python3
+"""Pack an ASCII room map into a one-bit-per-tile collision grid.
+
+Each map character is looked up in the tileset metadata
+(assets/maps/tileset.collision: "<tile> <solid|open> <char>" per line) and
+the solid flags are written as:
+
+    u8  width in tiles (power of two, multiple of 8)
+    u8  height in tiles
+    u8  row shift (log2 of the bytes per row)
+    u8  reserved (0)
+    height x row bytes, bit 7 of the first byte = leftmost tile
+
+Both files use ';' for comments ('#' is a map char). Maps narrower than a
+power of two are padded with solid tiles, so a row starts at
+(y << row shift). Maps are at most MAX_ROWS tall (COLLISION_MAX_ROWS in
+src/collision.h, the size of the game's row offset table).
+
+Usage: gen_collision.py <tileset.collision> <room.txt> <output>
+"""
+import sys
+
+MAX_ROWS = 64
+
+
+def read_tileset(path):
+    solid = {}
+    with open(path, "r", encoding="utf-8") as meta:
+        for number, raw in enumerate(meta, 1):
+            line = raw.split(";", 1)[0].strip()
+            if not line:
+                continue
+            fields = line.split()
+            if len(fields) != 3 or fields[1] not in ("solid", "open") or len(fields[2]) != 1:
+                raise ValueError(f"{path}:{number}: expected '<tile> <solid|open> <char>'")
+            solid[fields[2]] = fields[1] == "solid"
+    return solid
+
+
+def read_map(path):
+    rows = []
+    with open(path, "r", encoding="utf-8") as room:
+        for raw in room:
+            line = raw.rstrip("\n")
+            if line.startswith(";"):
+                continue  # Comment ('#' is a map char)
+            if line:
+                rows.append(line)
+    return rows
+
+
+def pack(rows, solid, path):
+    width = max(len(row) for row in rows)
+    padded = 8
+    while padded < width:
+        padded *= 2
+    if padded > 255 or len(rows) > 255:
+        raise ValueError(f"{path}: map is larger than 255 tiles")
+    if len(rows) > MAX_ROWS:
+        raise ValueError(f"{path}: map is taller than {MAX_ROWS} rows")
+    row_bytes = padded // 8
+    row_shift = row_bytes.bit_length() - 1
+
+    out = bytearray([padded, len(rows), row_shift, 0])
+    for y, row in enumerate(rows):
+        bits = bytearray(row_bytes)
+        for x in range(padded):
+            char = row[x] if x < len(row) else None
+            if char is not None and char not in solid:
+                raise ValueError(f"{path}:{y + 1}: '{char}' is not in the tileset metadata")
+            if char is None or solid[char]:
+                bits[x >> 3] |= 0x80 >> (x & 7)
+        out += bits
+    return out
+
+
+def main():
+    if len(sys.argv) != 4:
+        sys.stderr.write("usage: gen_collision.py <tileset.collision> <room.txt> <output>\n")
+        return 2
+
+    meta, room, output = sys.argv[1:]
+    try:
+        solid = read_tileset(meta)
+        rows = read_map(room)
+        data = pack(rows, solid, room)
+    except ValueError as error:
+        sys.stderr.write(f"gen_collision: {error}\n")
+        return 1
+
+    with open(output, "wb") as out:
+        out.write(data)
+    print(f"{room}: {data[0]}x{data[1]} tiles, {len(data)} bytes -> {output}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
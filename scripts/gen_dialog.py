@@ -0,0 +1,159 @@
+#!/usr/bin/env python3
+"""Word-wrap and page dialog text into the bank read by src/text.c.
+
+The source (assets/text/dialog.txt) is a list of "[name]" sections; the
+section order is the dialog id order in src/text.h. Within a section, blank
+lines separate paragraphs and a line holding only "---" forces a new page.
+Each paragraph is wrapped to TEXT_DIALOG_COLUMNS and paged every
+TEXT_DIALOG_LINES lines (both read from src/text.h), so the game only ever
+copies characters and never measures words. Output:
+
+    u8  dialog count
+    u8  reserved (0)
+    u16 offset of each dialog from the start of the bank (little endian)
+    text: printable ASCII, 0x0A = next line, 0x0C = next page, 0x00 = end
+
+Lines starting with ';' are comments.
+
+Usage: gen_dialog.py <text.h> <dialog.txt> <output>
+"""
+import re
+import sys
+
+CODE_END = 0x00
+CODE_NEWLINE = 0x0A
+CODE_PAGE = 0x0C
+
+DEFINE = re.compile(r"^\s*#define\s+(TEXT_DIALOG_COLUMNS|TEXT_DIALOG_LINES)\s+(\d+)")
+SECTION = re.compile(r"^\[(\w+)\]$")
+
+
+def read_box_size(header):
+    values = {}
+    with open(header, "r", encoding="utf-8") as source:
+        for line in source:
+            match = DEFINE.match(line)
+            if match:
+                values[match.group(1)] = int(match.group(2))
+    if len(values) != 2:
+        raise ValueError(f"{header}: TEXT_DIALOG_COLUMNS/TEXT_DIALOG_LINES not found")
+    return values["TEXT_DIALOG_COLUMNS"], values["TEXT_DIALOG_LINES"]
+
+
+def read_sections(path):
+    """Return [(name, [page, ...])] where a page is a list of paragraphs."""
+    sections = []
+    with open(path, "r", encoding="utf-8") as source:
+        for number, raw in enumerate(source, 1):
+            line = raw.strip()
+            if line.startswith(";"):
+                continue
+            match = SECTION.match(line)
+            if match:
+                sections.append((match.group(1), [[[]]]))
+                continue
+            if not sections:
+                if line:
+                    raise ValueError(f"{path}:{number}: text before the first [section]")
+                continue
+
+            pages = sections[-1][1]
+            if line == "---":
+                pages.append([[]])
+            elif not line:
+                if pages[-1][-1]:
+                    pages[-1].append([])
+            else:
+                for char in line:
+                    if not " " <= char <= "~":
+                        raise ValueError(f"{path}:{number}: non-ASCII character {char!r}")
+                pages[-1][-1].extend(line.split())
+    return sections
+
+
+def wrap(words, columns, where):
+    lines = []
+    current = ""
+    for word in words:
+        if len(word) > columns:
+            raise ValueError(f"{where}: word '{word}' is wider than the box")
+        if not current:
+            current = word
+        elif len(current) + 1 + len(word) <= columns:
+            current += " " + word
+        else:
+            lines.append(current)
+            current = word
+    if current:
+        lines.append(current)
+    return lines
+
+
+def layout(name, pages, columns, rows):
+    """Wrap every paragraph and split the result into box-sized pages."""
+    boxes = []
+    for page in pages:
+        lines = []
+        for paragraph in page:
+            if not paragraph:
+                continue
+            if lines:
+                lines.append("")  # Blank line between paragraphs
+            lines.extend(wrap(paragraph, columns, name))
+        while lines:
+            box = lines[:rows]
+            lines = lines[rows:]
+            while lines and not lines[0]:
+                lines.pop(0)  # Never start a page on a paragraph gap
+            while box and not box[-1]:
+                box.pop()
+            boxes.append(box)
+    if not boxes:
+        raise ValueError(f"[{name}]: empty dialog")
+
+    out = bytearray()
+    for index, box in enumerate(boxes):
+        if index:
+            out.append(CODE_PAGE)
+        out += "\n".join(box).encode("ascii")
+    out.append(CODE_END)
+    return out, len(boxes)
+
+
+def main():
+    if len(sys.argv) != 4:
+        sys.stderr.write("usage: gen_dialog.py <text.h> <dialog.txt> <output>\n")
+        return 2
+
+    header, source, output = sys.argv[1:]
+    try:
+        columns, rows = read_box_size(header)
+        sections = read_sections(source)
+        if not sections or len(sections) > 255:
+            raise ValueError(f"{source}: expected 1-255 [sections]")
+
+        table = bytearray([len(sections), 0])
+        text = bytearray()
+        summary = []
+        base = 2 + 2 * len(sections)
+        for name, pages in sections:
+            data, count = layout(name, pages, columns, rows)
+            offset = base + len(text)
+            if offset > 0xFFFF:
+                raise ValueError(f"{source}: bank is larger than 64 KB")
+            table += offset.to_bytes(2, "little")
+            text += data
+            summary.append(f"{name}={count}")
+    except ValueError as error:
+        sys.stderr.write(f"gen_dialog: {error}\n")
+        return 1
+
+    with open(output, "wb") as out:
+        out.write(table + text)
+    print(f"{source}: {len(sections)} dialogs ({', '.join(summary)} pages), "
+          f"{len(table) + len(text)} bytes -> {output}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
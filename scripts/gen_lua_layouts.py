@@ -0,0 +1,205 @@
+#!/usr/bin/env python3
+"""Generate Lua struct layouts for the game globals from the C headers.
+
+Emits two Lua tables for tests/lib/game_memory.lua:
+
+    LAYOUTS[TypeName] = { size = n, fields = { name = {offset, type, count}, ... } }
+    GLOBALS[name]     = { type, count }
+
+Offsets follow 816-tcc: u8/s8 are 1 byte, u16/s16 and enums 2 bytes,
+pointers 4 bytes; 16-bit (and larger) members and any struct containing
+them are 2-byte aligned.
+
+    python3 scripts/gen_lua_layouts.py src > build/layouts.lua
+"""
+
+import glob
+import os
+import re
+import sys
+
+PRIMITIVES = {
+    "u8": (1, 1), "s8": (1, 1), "char": (1, 1), "bool": (1, 1),
+    "u16": (2, 2), "s16": (2, 2), "int": (2, 2), "short": (2, 2),
+    "u32": (4, 2), "s32": (4, 2), "long": (4, 2),
+}
+POINTER = (4, 2)
+
+DEFINE = re.compile(r"^\s*#define\s+([A-Z_][A-Z0-9_]*)\s+(.+?)\s*(//.*)?$")
+MACRO = re.compile(r"^\s*#define\s+([A-Z_][A-Z0-9_]*)\(([\w\s,]*)\)\s+(.+?)\s*(//.*)?$")
+TYPEDEF = re.compile(r"typedef\s+(struct|enum)\s*(?:\w+\s*)?\{(.*?)\}\s*(\w+)\s*;", re.S)
+EXTERN = re.compile(r"^extern\s+(?:const\s+)?(\w+)\s+(\w+)\s*(?:\[(\w+)\])?\s*;", re.M)
+MEMBER = re.compile(r"^(?:const\s+)?(\w+)\s*(\*?)\s*(\w+)\s*(?:\[([^\]]+)\])?$")
+FUNCTION_POINTER = re.compile(r"^(?:const\s+)?\w+\s*\*?\s*\(\s*\*\s*(\w+)\s*\)\s*\(.*\)$")
+
+
+def strip_comments(text):
+    text = re.sub(r"/\*.*?\*/", "", text, flags=re.S)
+    return re.sub(r"//[^\n]*", "", text)
+
+
+class Layouts:
+    def __init__(self):
+        self.constants = {}
+        self.macros = {}      # name -> ([params], body) for function-like #defines
+        self.enums = set()
+        self.structs = {}     # name -> (size, align, [(field, offset, type, count)])
+        self.globals = {}     # name -> (type, count)
+
+    def expand_macros(self, expr):
+        call = re.compile(r"\b(%s)\s*\(([^()]*(?:\([^()]*\)[^()]*)*)\)" % "|".join(self.macros)) \
+            if self.macros else None
+        for _ in range(16):
+            match = call.search(expr) if call else None
+            if not match:
+                break
+            params, body = self.macros[match.group(1)]
+            args = [arg.strip() for arg in match.group(2).split(",")]
+            for param, arg in zip(params, args):
+                body = re.sub(r"\b%s\b" % param, "(%s)" % arg, body)
+            expr = expr[:match.start()] + "(%s)" % body + expr[match.end():]
+        return expr
+
+    def evaluate(self, expr):
+        expr = self.expand_macros(expr.strip())
+        tokens = re.findall(r"[A-Za-z_]\w*", expr)
+        for token in sorted(set(tokens), key=len, reverse=True):
+            if token in self.constants:
+                expr = re.sub(r"\b%s\b" % token, str(self.constants[token]), expr)
+        if not re.match(r"^[\d\s()+\-*/<>x]+$", expr.replace("0x", "")):
+            raise ValueError("cannot evaluate '%s'" % expr)
+        return int(eval(expr.replace("/", "//"), {"__builtins__": {}}))
+
+    def add_defines(self, text):
+        for line in text.splitlines():
+            macro = MACRO.match(line)
+            if macro:
+                params = [param.strip() for param in macro.group(2).split(",") if param.strip()]
+                self.macros[macro.group(1)] = (params, macro.group(3))
+                continue
+            match = DEFINE.match(line)
+            if not match:
+                continue
+            try:
+                self.constants[match.group(1)] = self.evaluate(match.group(2))
+            except (ValueError, SyntaxError):
+                pass  # Not a numeric constant
+
+    def add_enum(self, name, body):
+        value = -1
+        for item in body.split(","):
+            item = item.strip()
+            if not item:
+                continue
+            if "=" in item:
+                key, expr = item.split("=", 1)
+                value = self.evaluate(expr)
+                key = key.strip()
+            else:
+                key = item
+                value += 1
+            self.constants[key] = value
+        self.enums.add(name)
+
+    def type_info(self, type_name, pointer):
+        if pointer:
+            return POINTER
+        if type_name in PRIMITIVES:
+            return PRIMITIVES[type_name]
+        if type_name in self.enums:
+            return (2, 2)
+        if type_name in self.structs:
+            size, align, _ = self.structs[type_name]
+            return (size, align)
+        raise KeyError(type_name)
+
+    def add_struct(self, name, body):
+        offset = 0
+        struct_align = 1
+        fields = []
+        for decl in body.split(";"):
+            decl = " ".join(decl.split())
+            if not decl:
+                continue
+            function = FUNCTION_POINTER.match(decl)
+            if function:
+                decl = "void *%s" % function.group(1)
+            match = MEMBER.match(decl)
+            if not match:
+                raise ValueError("%s: cannot parse member '%s'" % (name, decl))
+            type_name, pointer, field, count = match.groups()
+            size, align = self.type_info(type_name, pointer)
+            count = self.evaluate(count) if count else 1
+            if offset % align:
+                offset += align - offset % align
+            struct_align = max(struct_align, align)
+            lua_type = "ptr" if pointer else type_name
+            fields.append((field, offset, lua_type, count if match.group(4) else 0))
+            offset += size * count
+        if offset % struct_align:
+            offset += struct_align - offset % struct_align
+        self.structs[name] = (offset, struct_align, fields)
+
+    def add_header(self, text):
+        text = strip_comments(text)
+        self.add_defines(text)
+        for kind, body, name in TYPEDEF.findall(text):
+            if kind == "enum":
+                self.add_enum(name, body)
+            else:
+                self.add_struct(name, body)
+        for type_name, name, count in EXTERN.findall(text):
+            if type_name in self.structs or type_name in PRIMITIVES and type_name != "char":
+                self.globals[name] = (type_name, self.evaluate(count) if count else 0)
+
+
+def load(src_dir):
+    layouts = Layouts()
+    headers = {}
+    for path in sorted(glob.glob(os.path.join(src_dir, "*.h"))):
+        with open(path, "r", encoding="utf-8") as header:
+            headers[path] = header.read()
+
+    # Headers depend on each other's constants and types: retry until stable
+    pending = dict(headers)
+    while pending:
+        progress = False
+        for path, text in list(pending.items()):
+            try:
+                layouts.add_header(text)
+            except (KeyError, ValueError):
+                continue
+            del pending[path]
+            progress = True
+        if not progress:
+            path, text = next(iter(pending.items()))
+            layouts.add_header(text)  # Raise the real error
+    return layouts
+
+
+def main(argv):
+    if len(argv) != 2:
+        sys.stderr.write("usage: gen_lua_layouts.py <src dir>\n")
+        return 2
+
+    layouts = load(argv[1])
+    out = sys.stdout
+    out.write("-- Generated by scripts/gen_lua_layouts.py from %s/*.h - do not edit\n" % argv[1])
+    out.write("local LAYOUTS = {\n")
+    for name in sorted(layouts.structs):
+        size, _, fields = layouts.structs[name]
+        out.write("    %s = { size = %d, fields = {\n" % (name, size))
+        for field, offset, lua_type, count in fields:
+            out.write("        %s = {%d, \"%s\", %d},\n" % (field, offset, lua_type, count))
+        out.write("    } },\n")
+    out.write("}\n")
+    out.write("local GLOBALS = {\n")
+    for name in sorted(layouts.globals):
+        type_name, count = layouts.globals[name]
+        out.write("    %s = {\"%s\", %d},\n" % (name, type_name, count))
+    out.write("}\n\n")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
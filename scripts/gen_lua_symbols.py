@@ -0,0 +1,61 @@
+#!/usr/bin/env python3
+"""Turn the wlalink .sym file into a Lua prelude for the emulator tests.
+
+Mesen's headless Lua cannot read files, so test scripts get their symbol
+addresses by having this prelude concatenated in front of them:
+
+    python3 scripts/gen_lua_symbols.py build/ChronicEchos.sym > build/symbols.lua
+    cat build/symbols.lua tests/perf/perf_suite.lua > build/perf_run.lua
+
+The .sym file has been through `gsed 's/://'`, so label lines read
+`BBAAAA name` (bank + address, hex).
+"""
+
+import re
+import sys
+
+LABEL_LINE = re.compile(r"^([0-9a-fA-F]{2}):?([0-9a-fA-F]{4})\s+(\S+)$")
+LUA_NAME = re.compile(r"^[A-Za-z_][A-Za-z0-9_]*$")
+
+
+def read_symbols(path):
+    symbols = {}
+    section = None
+    with open(path, "r", encoding="utf-8", errors="replace") as sym:
+        for raw in sym:
+            line = raw.strip()
+            if not line or line.startswith(";"):
+                continue
+            if line.startswith("["):
+                section = line.lower()
+                continue
+            if section != "[labels]":
+                continue
+            match = LABEL_LINE.match(line)
+            if not match:
+                continue
+            bank, addr, name = match.groups()
+            # Skip compiler locals and keep the first definition (-c allows dupes)
+            if not LUA_NAME.match(name) or name.startswith("__") or name in symbols:
+                continue
+            symbols[name] = (int(bank, 16) << 16) | int(addr, 16)
+    return symbols
+
+
+def main(argv):
+    if len(argv) != 2:
+        sys.stderr.write("usage: gen_lua_symbols.py <rom.sym>\n")
+        return 2
+
+    symbols = read_symbols(argv[1])
+    out = sys.stdout
+    out.write("-- Generated by scripts/gen_lua_symbols.py from %s - do not edit\n" % argv[1])
+    out.write("local SYMBOLS = {\n")
+    for name in sorted(symbols):
+        out.write("    %s = 0x%06X,\n" % (name, symbols[name]))
+    out.write("}\n\n")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
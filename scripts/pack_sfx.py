@@ -0,0 +1,102 @@
+#!/usr/bin/env python3
+"""Pack sound effect WAVs into a single BRR bank for the SPC700.
+
+Reads the sample list from assets/audio/sfx/sfx.list (one WAV name per line,
+in SFX_* id order), encodes each 16-bit or 8-bit mono WAV to BRR and writes:
+
+    u8  count
+    u8  reserved (0)
+    count x { u16 offset, u16 length }   (little endian, relative to bank start)
+    BRR data, 9 bytes per 16-sample block
+
+Usage: pack_sfx.py <sfx dir> <output bank>
+"""
+import os
+import struct
+import sys
+import wave
+
+BRR_BLOCK_SAMPLES = 16
+
+
+def read_wav(path):
+    with wave.open(path, "rb") as wav:
+        if wav.getnchannels() != 1:
+            raise ValueError(f"{path}: expected mono audio")
+        width = wav.getsampwidth()
+        frames = wav.readframes(wav.getnframes())
+
+    if width == 2:
+        return list(struct.unpack(f"<{len(frames) // 2}h", frames))
+    if width == 1:
+        return [(b - 128) << 8 for b in frames]
+    raise ValueError(f"{path}: unsupported sample width {width}")
+
+
+def encode_block(samples):
+    """Encode 16 samples with filter 0, picking the shift with least error."""
+    best = None
+    for shift in range(13):
+        nibbles = []
+        error = 0
+        for sample in samples:
+            value = (sample * 2) >> shift if shift else sample * 2
+            nibble = max(-8, min(7, value))
+            decoded = (nibble << shift) >> 1
+            error += abs(decoded - sample)
+            nibbles.append(nibble & 0x0F)
+        if best is None or error < best[0]:
+            best = (error, shift, nibbles)
+
+    _, shift, nibbles = best
+    data = bytes((nibbles[i] << 4) | nibbles[i + 1] for i in range(0, BRR_BLOCK_SAMPLES, 2))
+    return shift, data
+
+
+def encode_brr(samples):
+    # Pad to whole blocks with silence
+    remainder = len(samples) % BRR_BLOCK_SAMPLES
+    if remainder:
+        samples = samples + [0] * (BRR_BLOCK_SAMPLES - remainder)
+
+    out = bytearray()
+    blocks = len(samples) // BRR_BLOCK_SAMPLES
+    for block in range(blocks):
+        shift, data = encode_block(samples[block * BRR_BLOCK_SAMPLES:(block + 1) * BRR_BLOCK_SAMPLES])
+        header = shift << 4
+        if block == blocks - 1:
+            header |= 0x01  # End flag, no loop
+        out.append(header)
+        out += data
+    return bytes(out)
+
+
+def main():
+    if len(sys.argv) != 3:
+        print(__doc__)
+        return 1
+
+    sfx_dir, output = sys.argv[1], sys.argv[2]
+    with open(os.path.join(sfx_dir, "sfx.list")) as f:
+        names = [line.strip() for line in f if line.strip() and not line.startswith("#")]
+
+    samples = [encode_brr(read_wav(os.path.join(sfx_dir, name))) for name in names]
+
+    header_size = 2 + 4 * len(samples)
+    directory = bytearray([len(samples), 0])
+    offset = header_size
+    for brr in samples:
+        directory += struct.pack("<HH", offset, len(brr))
+        offset += len(brr)
+
+    with open(output, "wb") as f:
+        f.write(directory)
+        for brr in samples:
+            f.write(brr)
+
+    print(f"Packed {len(samples)} samples, {offset} bytes -> {output}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
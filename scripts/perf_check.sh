@@ -0,0 +1,86 @@
+#!/usr/bin/env bash
+
+# Chronic Echo Performance Check
+# Runs tests/perf/perf_suite.lua in snes_test and compares the PERF lines
+# against tests/perf/baseline.txt.
+#
+# Usage: scripts/perf_check.sh [--update]
+#   --update         rewrite the baseline from this run
+#   PERF_THRESHOLD   allowed growth in percent (default 10)
+#   PERF_MIN_DELTA   ignore growth below this many cycles (default 200)
+
+set -e
+
+ROM="${ROM:-build/ChronicEchos.sfc}"
+BASELINE="${BASELINE:-tests/perf/baseline.txt}"
+THRESHOLD="${PERF_THRESHOLD:-10}"
+MIN_DELTA="${PERF_MIN_DELTA:-200}"
+OUT_DIR="$(dirname "$ROM")"
+RUN_SCRIPT="$OUT_DIR/perf_run.lua"
+RESULTS="$OUT_DIR/perf_results.txt"
+PRELUDE="$OUT_DIR/lua_prelude.lua"
+
+if [ ! -f "$ROM" ] || [ ! -f "$PRELUDE" ]; then
+    echo "Error: $ROM or $PRELUDE missing. Run 'make perf' instead."
+    exit 1
+fi
+
+# Prelude (symbols, layouts, accessors) + suite: headless Lua cannot read files
+cat "$PRELUDE" tests/perf/perf_suite.lua > "$RUN_SCRIPT"
+
+echo "Running performance suite..."
+./snes_test lua "$ROM" "$RUN_SCRIPT" | tee "$OUT_DIR/perf_output.txt" | grep -v '^PERF ' || true
+grep '^PERF ' "$OUT_DIR/perf_output.txt" | cut -d' ' -f2- | sort > "$RESULTS"
+
+if ! grep -q '^PERF_STATUS done' "$OUT_DIR/perf_output.txt"; then
+    echo "Error: performance suite did not complete"
+    exit 1
+fi
+
+if [ "$1" = "--update" ]; then
+    {
+        echo "# scenario metric cycles - regenerate with: make perf-baseline"
+        cat "$RESULTS"
+    } > "$BASELINE"
+    echo "Baseline updated: $BASELINE ($(wc -l < "$RESULTS") metrics)"
+    exit 0
+fi
+
+# Without recorded metrics every line would be NEW and the check would pass
+# without comparing anything
+if ! grep -qv '^#' "$BASELINE" 2>/dev/null; then
+    echo "Error: no metrics in $BASELINE. Record them with 'make perf-baseline'."
+    exit 1
+fi
+
+# Only cycle metrics gate the run; scanline_max and arena bytes are
+# informational (budget_report.py checks the arena)
+awk -v threshold="$THRESHOLD" -v minDelta="$MIN_DELTA" '
+    FNR == NR {
+        if ($0 !~ /^#/ && NF == 3) base[$1 " " $2] = $3
+        next
+    }
+    {
+        key = $1 " " $2
+        if (!(key in base)) {
+            printf "  NEW   %-40s %8d\n", key, $3
+            next
+        }
+        old = base[key]
+        delta = $3 - old
+        pct = old > 0 ? delta * 100.0 / old : 0
+        if ($2 !~ /scanline|arena/ && delta > minDelta && pct > threshold) {
+            printf "  SLOW  %-40s %8d -> %8d (+%.1f%%)\n", key, old, $3, pct
+            regressions++
+        } else if (delta < -minDelta && pct < -threshold) {
+            printf "  FAST  %-40s %8d -> %8d (%.1f%%)\n", key, old, $3, pct
+        }
+    }
+    END {
+        if (regressions > 0) {
+            printf "%d metric(s) regressed by more than %s%%\n", regressions, threshold
+            exit 1
+        }
+        print "Performance within threshold"
+    }
+' "$BASELINE" "$RESULTS"
@@ -0,0 +1,109 @@
+#!/usr/bin/env bash
+
+# Chronic Echo Golden Replay Check
+# Plays each tests/replay/*.input through tests/replay/replay.lua and compares
+# the per-frame WRAM hashes with tests/replay/<name>.golden.
+#
+# Usage: scripts/replay_check.sh [--update] [name ...]
+#   --update             rewrite the golden files from this run
+#   REPLAY_FB_INTERVAL   also hash the framebuffer every N frames (default 0)
+
+set -e
+
+ROM="${ROM:-build/ChronicEchos.sfc}"
+OUT_DIR="$(dirname "$ROM")/replay"
+PRELUDE="$(dirname "$ROM")/lua_prelude.lua"
+FB_INTERVAL="${REPLAY_FB_INTERVAL:-0}"
+
+UPDATE=0
+if [ "$1" = "--update" ]; then
+    UPDATE=1
+    shift
+fi
+
+if [ ! -f "$ROM" ] || [ ! -f "$PRELUDE" ]; then
+    echo "Error: $ROM or $PRELUDE missing. Run 'make replay' instead."
+    exit 1
+fi
+
+if [ $# -gt 0 ]; then
+    NAMES=("$@")
+else
+    NAMES=()
+    for input in tests/replay/*.input; do
+        NAMES+=("$(basename "$input" .input)")
+    done
+fi
+
+mkdir -p "$OUT_DIR"
+FAILED=0
+
+for name in "${NAMES[@]}"; do
+    input="tests/replay/$name.input"
+    golden="tests/replay/$name.golden"
+    script="$OUT_DIR/$name.lua"
+    hashes="$OUT_DIR/$name.hashes"
+
+    # Prelude + input script as a Lua string (headless Lua cannot read files)
+    {
+        cat "$PRELUDE"
+        echo "local REPLAY_FB_INTERVAL = $FB_INTERVAL"
+        echo "local REPLAY_SCRIPT = [==["
+        cat "$input"
+        echo "]==]"
+        cat tests/replay/replay.lua
+    } > "$script"
+
+    start=$(date +%s)
+    ./snes_test lua "$ROM" "$script" > "$OUT_DIR/$name.log" 2>&1 || true
+    grep -E '^HASH(COLS)? ' "$OUT_DIR/$name.log" > "$hashes" || true
+    frames=$(grep -c '^HASH ' "$hashes" || true)
+
+    if ! grep -q '^REPLAY_STATUS done' "$OUT_DIR/$name.log"; then
+        echo "FAIL  $name: replay did not finish (see $OUT_DIR/$name.log)"
+        FAILED=1
+        continue
+    fi
+
+    if [ "$UPDATE" = "1" ]; then
+        cp "$hashes" "$golden"
+        echo "GOLD  $name: $frames frames written to $golden"
+        continue
+    fi
+
+    # No golden stream means nothing was checked: fail rather than pass
+    if [ ! -f "$golden" ]; then
+        echo "FAIL  $name: no golden file (record one with 'make replay-golden')"
+        FAILED=1
+        continue
+    fi
+
+    # First diverging frame and the regions that differ there
+    if awk '
+        FNR == 1 && /^HASHCOLS/ { for (i = 2; i <= NF; i++) col[i] = $i; next }
+        FNR == NR { golden[FNR] = $0; goldenCount = FNR; next }
+        {
+            if (!(FNR in golden)) { printf "  extra frame %s beyond the golden stream\n", $2; bad = 1; exit }
+            if ($0 != golden[FNR]) {
+                split(golden[FNR], g, " ")
+                regions = ""
+                for (i = 3; i <= NF; i++) if ($i != g[i]) regions = regions " " col[i]
+                printf "  first divergence at frame %s:%s\n", $2, regions
+                bad = 1; exit
+            }
+            seen = FNR
+        }
+        END {
+            if (!bad && seen < goldenCount) { printf "  replay stopped %d frames early\n", goldenCount - seen; bad = 1 }
+            exit bad
+        }
+    ' "$golden" "$hashes" > "$OUT_DIR/$name.diff"; then
+        echo "PASS  $name: $frames frames match ($(($(date +%s) - start)) s)"
+    else
+        echo "FAIL  $name:"
+        cat "$OUT_DIR/$name.diff"
+        FAILED=1
+    fi
+done
+
+exit $FAILED
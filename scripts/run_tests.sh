@@ -0,0 +1,117 @@
+#!/usr/bin/env bash
+
+# Chronic Echo Parallel Test Runner
+# Boots the ROM once, snapshots "in game, fade-in complete", then runs every
+# tests/*.lua as its own snes_test process, JOBS at a time, and merges the
+# results into one report.
+#
+# Usage: scripts/run_tests.sh [test.lua ...]
+#   JOBS          parallel processes (default: CPU count)
+#   TEST_TIMEOUT  seconds before a test is killed (default 300, needs timeout)
+
+set -e
+
+ROM="${ROM:-build/ChronicEchos.sfc}"
+OUT_DIR="$(dirname "$ROM")/tests"
+PRELUDE="$(dirname "$ROM")/lua_prelude.lua"
+JOBS="${JOBS:-$(getconf _NPROCESSORS_ONLN 2>/dev/null || echo 2)}"
+TEST_TIMEOUT="${TEST_TIMEOUT:-300}"
+
+if [ ! -f "$ROM" ] || [ ! -f "$PRELUDE" ]; then
+    echo "Error: $ROM or $PRELUDE missing. Run 'make test' instead."
+    exit 1
+fi
+
+if [ $# -gt 0 ]; then
+    TESTS=("$@")
+else
+    TESTS=(tests/*.lua)
+fi
+
+now_ms() {
+    python3 -c 'import time; print(int(time.time() * 1000))'
+}
+
+rm -rf "$OUT_DIR"
+mkdir -p "$OUT_DIR"
+SUITE_START=$(now_ms)
+
+#---------------------------------------------------------------------------------
+# 1. Boot once and capture the snapshot (hex on stdout: Lua cannot write files)
+echo "Creating boot snapshot..."
+cat "$PRELUDE" tests/lib/make_snapshot.lua > "$OUT_DIR/make_snapshot.lua"
+./snes_test lua "$ROM" "$OUT_DIR/make_snapshot.lua" > "$OUT_DIR/make_snapshot.log" 2>&1 || true
+
+if grep -q '^SNAPSHOT_END' "$OUT_DIR/make_snapshot.log"; then
+    {
+        printf 'BOOT_SNAPSHOT_HEX = "'
+        grep '^SNAPSHOT ' "$OUT_DIR/make_snapshot.log" | cut -c10- | tr -d '\n'
+        printf '"\n'
+    } > "$OUT_DIR/snapshot.lua"
+    echo "Snapshot ready ($(($(grep '^SNAPSHOT ' "$OUT_DIR/make_snapshot.log" | cut -c10- | tr -d '\n' | wc -c) / 2)) bytes)"
+else
+    echo "Warning: no snapshot captured; tests will boot from power-on"
+    echo 'BOOT_SNAPSHOT_HEX = nil' > "$OUT_DIR/snapshot.lua"
+fi
+
+#---------------------------------------------------------------------------------
+# 2. One self-contained script per test: snapshot + prelude + test
+for test in "${TESTS[@]}"; do
+    name=$(basename "$test" .lua)
+    cat "$OUT_DIR/snapshot.lua" "$PRELUDE" "$test" > "$OUT_DIR/$name.lua"
+done
+
+#---------------------------------------------------------------------------------
+# 3. Run in parallel; each job writes <name>.log and <name>.result
+run_one() {
+    local name="$1"
+    local start end status passed failed skipped
+    local runner=""
+
+    if command -v timeout > /dev/null; then
+        runner="timeout $TEST_TIMEOUT"
+    fi
+
+    start=$(now_ms)
+    if $runner ./snes_test lua "$ROM" "$OUT_DIR/$name.lua" > "$OUT_DIR/$name.log" 2>&1; then
+        status=ok
+    else
+        status=error
+    fi
+    end=$(now_ms)
+
+    passed=$(grep -c '\[PASS\]' "$OUT_DIR/$name.log" || true)
+    failed=$(grep -c '\[FAIL\]' "$OUT_DIR/$name.log" || true)
+    skipped=$(grep -c '\[SKIP\]' "$OUT_DIR/$name.log" || true)
+    if [ "$failed" -gt 0 ]; then
+        status=fail
+    fi
+
+    echo "$name $status $passed $failed $skipped $((end - start))" > "$OUT_DIR/$name.result"
+}
+export -f run_one now_ms
+export ROM OUT_DIR TEST_TIMEOUT
+
+echo "Running ${#TESTS[@]} test scripts on $JOBS jobs..."
+for test in "${TESTS[@]}"; do
+    basename "$test" .lua
+done | xargs -P "$JOBS" -I{} bash -c 'run_one "$1"' _ {}
+
+#---------------------------------------------------------------------------------
+# 4. Merged report
+SUITE_END=$(now_ms)
+{
+    printf '%-32s %-6s %6s %6s %6s %10s\n' "test" "status" "pass" "fail" "skip" "ms"
+    cat "$OUT_DIR"/*.result | sort | while read -r name status passed failed skipped ms; do
+        printf '%-32s %-6s %6d %6d %6d %10d\n' "$name" "$status" "$passed" "$failed" "$skipped" "$ms"
+    done
+    awk '{ p += $3; f += $4; s += $5; cpu += $6; if ($2 != "ok") bad++ }
+         END { printf "Total: %d passed, %d failed, %d skipped; %d script(s) not ok; %d ms test time\n", p, f, s, bad, cpu }' \
+        "$OUT_DIR"/*.result
+    echo "Wall clock: $((SUITE_END - SUITE_START)) ms with $JOBS jobs"
+} | tee "$OUT_DIR/report.txt"
+
+if grep -qv ' ok ' "$OUT_DIR"/*.result; then
+    echo "Failing logs: $OUT_DIR/<test>.log"
+    exit 1
+fi
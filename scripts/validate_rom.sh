@@ -49,6 +49,18 @@ fi
 
 echo "📊 ROM content density: ${NON_ZERO_RATIO}% non-zero bytes"
 
+# LoROM header at $7FC0: saves need battery-backed SRAM (hdr.asm, src/save.h)
+LOROM_HEADER=32704
+if [ $SIZE -gt $((LOROM_HEADER + 32)) ]; then
+    CART_TYPE=$(dd if="$ROM_FILE" bs=1 skip=$((LOROM_HEADER + 0x16)) count=1 2>/dev/null | od -An -tu1 | tr -d ' ')
+    SRAM_SIZE=$(dd if="$ROM_FILE" bs=1 skip=$((LOROM_HEADER + 0x18)) count=1 2>/dev/null | od -An -tu1 | tr -d ' ')
+    if [ "$CART_TYPE" != "2" ] || [ "$SRAM_SIZE" != "3" ]; then
+        echo "❌ Header does not declare 8 KB battery SRAM (cartridge type $CART_TYPE, SRAM size $SRAM_SIZE; expected 2 and 3)"
+        exit 1
+    fi
+    echo "💾 Battery SRAM declared: 8 KB"
+fi
+
 # Try to detect SNES ROM header (basic format check)
 HEADER_OFFSET=65472  # SNES header location
 if [ $SIZE -gt 65536 ]; then
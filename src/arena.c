@@ -0,0 +1,87 @@
+/*---------------------------------------------------------------------------------
+
+
+    Chronic Echo - WRAM Arena Implementation
+    -- Scene-scoped bump allocator over WRAM bank $7F
+
+
+---------------------------------------------------------------------------------*/
+#include <snes.h>
+#include <string.h>  // For memset
+
+#include "arena.h"
+
+//---------------------------------------------------------------------------------
+// Global arena state
+Arena arena;
+
+//---------------------------------------------------------------------------------
+void initArena(void)
+{
+    memset(&arena, 0, sizeof(Arena));
+}
+
+//---------------------------------------------------------------------------------
+// Bump-allocate 'size' bytes (not cleared). Returns 0 when the arena is full;
+// nothing is freed individually, only by arenaRelease()/arenaPopScene().
+void *arenaAlloc(u16 size)
+{
+    u8 *block;
+
+    if (size > ARENA_SIZE - arena.top) {
+        arena.failures++;
+        return 0;
+    }
+
+    block = ARENA_PTR(arena.top);
+    arena.top += size;
+    if (arena.top > arena.highWater) {
+        arena.highWater = arena.top;
+    }
+    return block;
+}
+
+//---------------------------------------------------------------------------------
+// Current top, for releasing short-lived or partly allocated buffers (see
+// openFlowField) without leaving the scene
+u16 arenaMark(void)
+{
+    return arena.top;
+}
+
+//---------------------------------------------------------------------------------
+// Drop everything allocated since 'mark' in O(1)
+void arenaRelease(u16 mark)
+{
+    if (mark < arena.top) {
+        arena.top = mark;
+    }
+}
+
+//---------------------------------------------------------------------------------
+// Start a scene: everything allocated until the matching arenaPopScene() is
+// released together. Returns 0 when ARENA_MAX_MARKS scenes are already open.
+u8 arenaPushScene(void)
+{
+    if (arena.depth == ARENA_MAX_MARKS) {
+        return 0;
+    }
+    arena.marks[arena.depth++] = arena.top;
+    return 1;
+}
+
+//---------------------------------------------------------------------------------
+// End the innermost scene; its buffers must not be used afterwards
+void arenaPopScene(void)
+{
+    if (arena.depth == 0) {
+        return;
+    }
+    arena.top = arena.marks[--arena.depth];
+}
+
+//---------------------------------------------------------------------------------
+u16 arenaFree(void)
+{
+    return ARENA_SIZE - arena.top;
+}
@@ -0,0 +1,58 @@
+/*---------------------------------------------------------------------------------
+
+
+    Chronic Echo - WRAM Arena Header
+    -- Scene-scoped bump allocator over WRAM bank $7F
+
+
+---------------------------------------------------------------------------------*/
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <snes.h>
+
+//---------------------------------------------------------------------------------
+// Arena region: $7F:2000-$7F:FFFF. The low 8 KB of the bank is left to the
+// linker; budget.cfg repeats these values and the budget report fails if any
+// linked symbol lands inside the arena.
+#define ARENA_BANK 0x7F
+#define ARENA_BASE 0x2000
+#define ARENA_SIZE 0xE000
+
+// Nested scene marks (scene, then e.g. a menu or cutscene on top of it)
+#define ARENA_MAX_MARKS 4
+
+//---------------------------------------------------------------------------------
+// Long pointers: arena memory is outside bank $7E, so it is only reachable
+// through full 24-bit pointers. 816-tcc pointers are 4 bytes and dereference
+// with long addressing, so keep arena memory in ordinary pointer variables
+// (u8 *, Struct *) and never narrow one to a u16 offset. ARENA_PTR turns an
+// arena offset (e.g. a saved mark) back into a pointer.
+#define ARENA_ADDRESS(offset) (((u32)ARENA_BANK << 16) + ARENA_BASE + (offset))
+#define ARENA_PTR(offset) ((u8 *)ARENA_ADDRESS(offset))
+
+//---------------------------------------------------------------------------------
+// Arena State Structure
+typedef struct {
+    u16 top;                        // Bytes allocated (next free offset)
+    u16 highWater;                  // Largest top since boot
+    u16 failures;                   // Allocations refused for lack of space
+    u16 marks[ARENA_MAX_MARKS];     // top at each arenaPushScene()
+    u8 depth;                       // Scene marks pushed
+} Arena;
+
+//---------------------------------------------------------------------------------
+// External declarations
+extern Arena arena;
+
+//---------------------------------------------------------------------------------
+// Function declarations
+void initArena(void);
+void *arenaAlloc(u16 size);
+u16 arenaMark(void);
+void arenaRelease(u16 mark);
+u8 arenaPushScene(void);
+void arenaPopScene(void);
+u16 arenaFree(void);
+
+#endif // ARENA_H
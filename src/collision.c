@@ -0,0 +1,168 @@
+/*---------------------------------------------------------------------------------
+
+
+    Chronic Echo - Tile Collision Implementation
+    -- One-bit-per-tile collision grid with swept AABB movement
+
+
+---------------------------------------------------------------------------------*/
+#include <snes.h>
+
+#include "collision.h"
+
+//---------------------------------------------------------------------------------
+// Global collision map
+CollisionMap collisionMap;
+
+// Bit for a tile column within its byte (no variable-count shifts on the 65816)
+static const u8 tileBit[8] = { 0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01 };
+
+//---------------------------------------------------------------------------------
+// Pixel to tile coordinate; everything left of / above the map is tile -1
+static s16 pixelToTile(s16 pixel)
+{
+    if (pixel < 0) {
+        return -1;
+    }
+    return pixel >> COLLISION_TILE_SHIFT;
+}
+
+//---------------------------------------------------------------------------------
+// Any solid tile in column tileX between the pixel rows top..bottom?
+static u8 isColumnBlocked(s16 tileX, s16 top, s16 bottom)
+{
+    s16 tileY = pixelToTile(top);
+    s16 last = pixelToTile(bottom);
+
+    for (; tileY <= last; tileY++) {
+        if (isSolidTile(tileX, tileY)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+//---------------------------------------------------------------------------------
+// Any solid tile in row tileY between the pixel columns left..right?
+static u8 isRowBlocked(s16 tileY, s16 left, s16 right)
+{
+    s16 tileX = pixelToTile(left);
+    s16 last = pixelToTile(right);
+
+    for (; tileX <= last; tileX++) {
+        if (isSolidTile(tileX, tileY)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+//---------------------------------------------------------------------------------
+// Row start offsets, so isSolidTile() indexes a table instead of shifting by
+// rowShift (a runtime shift loop on the 65816)
+static void buildRowOffsets(void)
+{
+    u16 offset = 0;
+    u16 rowBytes = collisionMap.widthTiles >> 3;
+    u8 row;
+
+    for (row = 0; row < collisionMap.heightTiles; row++) {
+        collisionMap.rowOffset[row] = offset;
+        offset += rowBytes;
+    }
+}
+
+//---------------------------------------------------------------------------------
+void initCollision(void)
+{
+    collisionMap.bits = 0;
+    collisionMap.widthTiles = COLLISION_SCREEN_WIDTH_TILES;
+    collisionMap.heightTiles = COLLISION_SCREEN_HEIGHT_TILES;
+    collisionMap.rowShift = 2;
+    buildRowOffsets();
+}
+
+//---------------------------------------------------------------------------------
+// Point the collision layer at a packed grid (ROM or WRAM, header first).
+// Rows past COLLISION_MAX_ROWS are treated as outside the map.
+void setCollisionMap(u8 *data)
+{
+    collisionMap.widthTiles = data[0];
+    collisionMap.heightTiles = data[1] > COLLISION_MAX_ROWS ? COLLISION_MAX_ROWS : data[1];
+    collisionMap.rowShift = data[2];
+    collisionMap.bits = data + COLLISION_HEADER_SIZE;
+    buildRowOffsets();
+}
+
+//---------------------------------------------------------------------------------
+// Tiles outside the map are solid, so the map edge is always a wall
+u8 isSolidTile(s16 tileX, s16 tileY)
+{
+    if (tileX < 0 || tileY < 0 || tileX >= collisionMap.widthTiles || tileY >= collisionMap.heightTiles) {
+        return 1;
+    }
+    if (!collisionMap.bits) {
+        return 0;
+    }
+    return (collisionMap.bits[collisionMap.rowOffset[tileY] + (tileX >> 3)] & tileBit[tileX & 7]) != 0;
+}
+
+//---------------------------------------------------------------------------------
+u8 isSolidPoint(s16 x, s16 y)
+{
+    return isSolidTile(pixelToTile(x), pixelToTile(y));
+}
+
+//---------------------------------------------------------------------------------
+// Horizontal move of a width x height box at (x, y). Every tile column the
+// leading edge crosses is tested, so no speed can tunnel through a wall.
+// Returns the distance actually moved (dx, or up to the first wall).
+s16 sweepCollisionX(s16 x, s16 y, u8 width, u8 height, s16 dx)
+{
+    s16 top = y;
+    s16 bottom = y + height - 1;
+    s16 tileX, last;
+
+    if (dx > 0) {
+        last = pixelToTile(x + width - 1 + dx);
+        for (tileX = pixelToTile(x + width - 1) + 1; tileX <= last; tileX++) {
+            if (isColumnBlocked(tileX, top, bottom)) {
+                return (tileX << COLLISION_TILE_SHIFT) - width - x;
+            }
+        }
+    } else if (dx < 0) {
+        last = pixelToTile(x + dx);
+        for (tileX = pixelToTile(x) - 1; tileX >= last; tileX--) {
+            if (isColumnBlocked(tileX, top, bottom)) {
+                return ((tileX + 1) << COLLISION_TILE_SHIFT) - x;
+            }
+        }
+    }
+    return dx;
+}
+
+//---------------------------------------------------------------------------------
+// Vertical counterpart of sweepCollisionX()
+s16 sweepCollisionY(s16 x, s16 y, u8 width, u8 height, s16 dy)
+{
+    s16 left = x;
+    s16 right = x + width - 1;
+    s16 tileY, last;
+
+    if (dy > 0) {
+        last = pixelToTile(y + height - 1 + dy);
+        for (tileY = pixelToTile(y + height - 1) + 1; tileY <= last; tileY++) {
+            if (isRowBlocked(tileY, left, right)) {
+                return (tileY << COLLISION_TILE_SHIFT) - height - y;
+            }
+        }
+    } else if (dy < 0) {
+        last = pixelToTile(y + dy);
+        for (tileY = pixelToTile(y) - 1; tileY >= last; tileY--) {
+            if (isRowBlocked(tileY, left, right)) {
+                return ((tileY + 1) << COLLISION_TILE_SHIFT) - y;
+            }
+        }
+    }
+    return dy;
+}
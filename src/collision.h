@@ -0,0 +1,51 @@
+/*---------------------------------------------------------------------------------
+
+
+    Chronic Echo - Tile Collision Header
+    -- One-bit-per-tile collision grid with swept AABB movement
+
+
+---------------------------------------------------------------------------------*/
+#ifndef COLLISION_H
+#define COLLISION_H
+
+#include <snes.h>
+
+//---------------------------------------------------------------------------------
+// Grid constants (8x8 BG tiles)
+#define COLLISION_TILE_SHIFT 3
+#define COLLISION_TILE_SIZE (1 << COLLISION_TILE_SHIFT)
+#define COLLISION_HEADER_SIZE 4
+#define COLLISION_MAX_ROWS 64       // scripts/gen_collision.py refuses taller maps
+
+// Grid used until a map is loaded: the visible screen, open inside
+#define COLLISION_SCREEN_WIDTH_TILES 32
+#define COLLISION_SCREEN_HEIGHT_TILES 28
+
+//---------------------------------------------------------------------------------
+// Collision Map Structure (header layout matches scripts/gen_collision.py)
+typedef struct {
+    u8 *bits;           // Packed rows, bit 7 of a row's first byte = leftmost tile (0 = none)
+    u8 widthTiles;      // Tiles per row (power of two)
+    u8 heightTiles;     // Rows
+    u8 rowShift;        // log2(bytes per row)
+    u16 rowOffset[COLLISION_MAX_ROWS];  // Byte offset of each row in bits
+} CollisionMap;
+
+//---------------------------------------------------------------------------------
+// External declarations
+extern CollisionMap collisionMap;
+
+// Packed room grids (built by scripts/gen_collision.py)
+extern char collision_room0, collision_room0_end;
+
+//---------------------------------------------------------------------------------
+// Function declarations
+void initCollision(void);
+void setCollisionMap(u8 *data);
+u8 isSolidTile(s16 tileX, s16 tileY);
+u8 isSolidPoint(s16 x, s16 y);
+s16 sweepCollisionX(s16 x, s16 y, u8 width, u8 height, s16 dx);
+s16 sweepCollisionY(s16 x, s16 y, u8 width, u8 height, s16 dy);
+
+#endif // COLLISION_H
@@ -0,0 +1,123 @@
+/*---------------------------------------------------------------------------------
+
+
+    Chronic Echo - Echo Ghost Rendering Implementation
+    -- Translucent afterimages sampled from the position history
+
+
+---------------------------------------------------------------------------------*/
+#include <snes.h>
+#include <snes/sprite.h>
+
+#include "echoes.h"
+#include "sprites.h"
+#include "time_manipulation.h"
+#include "hdma_effects.h"
+#include "hw_registers.h"
+#include "oam_alloc.h"
+#include "obj_cache.h"
+
+//---------------------------------------------------------------------------------
+// Color math setup: sub screen = BG1, OBJ palettes 4-7 averaged with it
+#define ECHO_TS_BG1 0x01
+#define ECHO_CGWSEL_SUBSCREEN 0x02
+#define ECHO_CGADSUB_HALF_OBJ 0x50
+
+//---------------------------------------------------------------------------------
+// Global echo state
+EchoState echoes;
+
+//---------------------------------------------------------------------------------
+// Tinted copy of the sprite palette for the ghosts
+static u16 echoPalette[16];
+
+//---------------------------------------------------------------------------------
+// Build the ghost palette: halve red/green and lift blue for a cold tint
+static void buildEchoPalette(void)
+{
+    u16 *source = (u16 *)&sprites_simple_pal;
+    u16 color, r, g, b;
+    u8 i;
+
+    echoPalette[0] = source[0];  // Keep the transparent color
+    for (i = 1; i < 16; i++) {
+        color = source[i];
+        r = (color & 0x1F) >> 1;
+        g = ((color >> 5) & 0x1F) >> 1;
+        b = ((color >> 10) & 0x1F) | 0x10;
+        echoPalette[i] = r | (g << 5) | (b << 10);
+    }
+}
+
+//---------------------------------------------------------------------------------
+void initEchoes(void)
+{
+    echoes.enabled = 0;
+    echoes.count = ECHO_DEFAULT_COUNT;
+    echoes.stride = ECHO_STRIDE;
+    echoes.visibleCount = 0;
+
+    buildEchoPalette();
+    dmaCopyCGram((u8 *)echoPalette, 128 + ECHO_PALETTE * 16, sizeof(echoPalette));
+}
+
+//---------------------------------------------------------------------------------
+void setEchoesEnabled(u8 enabled)
+{
+    echoes.enabled = enabled;
+
+    if (enabled) {
+        // BG1 on the sub screen, half-add it under translucent OBJ palettes
+        HW_TS = ECHO_TS_BG1;
+        HW_CGADSUB = ECHO_CGADSUB_HALF_OBJ;
+        setColorMathSelect(ECHO_CGWSEL_SUBSCREEN);
+    } else {
+        HW_TS = 0;
+        HW_CGADSUB = 0;
+        setColorMathSelect(0);
+    }
+}
+
+//---------------------------------------------------------------------------------
+void setEchoCount(u8 count, u8 stride)
+{
+    echoes.count = (count > MAX_ECHOES) ? MAX_ECHOES : count;
+    echoes.stride = (stride == 0) ? 1 : stride;
+}
+
+//---------------------------------------------------------------------------------
+// Draw up to echoes.count ghosts. Each ghost is one index computation into the
+// circular history and one sprite request, so the cost is O(1) per ghost.
+void drawEchoes(void)
+{
+    u8 i;
+    u8 visible = 0;
+    u16 offset = 0;
+    u16 index;
+    u16 tile = OBJ_CACHE_NO_TILE;
+    PositionHistoryEntry *entry;
+
+    if (echoes.enabled) {
+        tile = objCacheTile(SPRITE_SHEET_SIMPLE, SPRITE_FRAME_PLAYER);
+    }
+    if (tile != OBJ_CACHE_NO_TILE) {
+        visible = echoes.count;
+        while (visible > 0 && (u16)visible * echoes.stride >= positionHistory.count) {
+            visible--;
+        }
+    }
+
+    for (i = 0; i < visible; i++) {
+        // Step back one stride from the newest entry (head - 1)
+        offset += echoes.stride;
+        index = positionHistory.head + POSITION_HISTORY_SIZE - 1 - offset;
+        if (index >= POSITION_HISTORY_SIZE) {
+            index -= POSITION_HISTORY_SIZE;
+        }
+
+        entry = &positionHistory.entries[index];
+        oamAllocRequest(entry->x, entry->y, tile, ECHO_PALETTE, ECHO_SPRITE_PRIORITY, 0, OAM_CLASS_ROTATING);
+    }
+
+    echoes.visibleCount = visible;
+}
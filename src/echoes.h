@@ -0,0 +1,42 @@
+/*---------------------------------------------------------------------------------
+
+
+    Chronic Echo - Echo Ghost Rendering Header
+    -- Translucent afterimages sampled from the position history
+
+
+---------------------------------------------------------------------------------*/
+#ifndef ECHOES_H
+#define ECHOES_H
+
+#include <snes.h>
+
+//---------------------------------------------------------------------------------
+// Echo Constants
+#define MAX_ECHOES 8
+#define ECHO_DEFAULT_COUNT 4
+#define ECHO_STRIDE 12            // History entries between consecutive ghosts
+#define ECHO_PALETTE 4            // OBJ palettes 4-7 take part in color math
+#define ECHO_SPRITE_PRIORITY 2    // Behind the player (priority 3)
+
+//---------------------------------------------------------------------------------
+// Echo State Structure
+typedef struct {
+    u8 enabled;         // Are echoes drawn at all?
+    u8 count;           // Requested number of ghosts (<= MAX_ECHOES)
+    u8 stride;          // History entries between ghosts
+    u8 visibleCount;    // Ghosts submitted this frame
+} EchoState;
+
+//---------------------------------------------------------------------------------
+// External declarations
+extern EchoState echoes;
+
+//---------------------------------------------------------------------------------
+// Function declarations
+void initEchoes(void);
+void setEchoesEnabled(u8 enabled);
+void setEchoCount(u8 count, u8 stride);
+void drawEchoes(void);
+
+#endif // ECHOES_H
@@ -0,0 +1,201 @@
+/*---------------------------------------------------------------------------------
+
+
+    Chronic Echo - Flow Field Implementation
+    -- Incremental BFS toward the player over the collision grid
+
+
+---------------------------------------------------------------------------------*/
+#include <snes.h>
+#include <string.h>  // For memcpy, memset
+
+#include "flow_field.h"
+#include "collision.h"
+#include "tasks.h"
+#include "arena.h"
+
+//---------------------------------------------------------------------------------
+// Global flow field state
+FlowField flowField;
+
+//---------------------------------------------------------------------------------
+// Claim a neighbour for the BFS: 'dir' is the step from it back toward the cell
+// being expanded. Blocked and already reached cells are both non-zero.
+static void visitCell(u16 index, u8 dir)
+{
+    if (flowField.building[index] != FLOW_NONE) {
+        return;
+    }
+    flowField.building[index] = dir;
+    flowField.queue[flowField.queueTail++] = index;
+}
+
+//---------------------------------------------------------------------------------
+static void expandCell(u16 index)
+{
+    u8 x = index & (FLOW_WIDTH - 1);
+
+    if (x > 0) {
+        visitCell(index - 1, FLOW_RIGHT);
+    }
+    if (x < FLOW_WIDTH - 1) {
+        visitCell(index + 1, FLOW_LEFT);
+    }
+    if (index >= FLOW_WIDTH) {
+        visitCell(index - FLOW_WIDTH, FLOW_DOWN);
+    }
+    if (index < FLOW_TILES - FLOW_WIDTH) {
+        visitCell(index + FLOW_WIDTH, FLOW_UP);
+    }
+}
+
+//---------------------------------------------------------------------------------
+// Worker task: waits for a new goal, copies the blank field in chunks, then
+// runs the BFS a few cells per step. The finished field swaps with the
+// published one, so agents never read a half-built field.
+static u8 flowTaskStep(Task *task)
+{
+    u8 n;
+
+    TASK_BEGIN(task);
+    while (1) {
+        while (!flowField.blank || flowField.target == FLOW_NO_GOAL ||
+               (flowField.published && flowField.target == flowField.goal)) {
+            TASK_WAIT_FRAME(task);
+        }
+        flowField.buildGoal = flowField.target;
+
+        for (task->counter = 0; task->counter < FLOW_TILES; task->counter += FLOW_CLEAR_CHUNK) {
+            memcpy(flowField.building + task->counter, flowField.blank + task->counter, FLOW_CLEAR_CHUNK);
+            TASK_YIELD(task);
+        }
+
+        flowField.building[flowField.buildGoal] = FLOW_GOAL;
+        flowField.queue[0] = flowField.buildGoal;
+        flowField.queueHead = 0;
+        flowField.queueTail = 1;
+        while (flowField.queueHead < flowField.queueTail) {
+            for (n = 0; n < FLOW_CELLS_PER_STEP && flowField.queueHead < flowField.queueTail; n++) {
+                expandCell(flowField.queue[flowField.queueHead++]);
+            }
+            TASK_YIELD(task);
+        }
+
+        flowField.published = flowField.building;
+        flowField.building = (flowField.published == flowField.fieldA) ? flowField.fieldB : flowField.fieldA;
+        flowField.goal = flowField.buildGoal;
+        flowField.builds++;
+    }
+    TASK_END(task);
+}
+
+//---------------------------------------------------------------------------------
+// Call after initTasks(). The worker idles until a field is opened.
+void initFlowField(void)
+{
+    memset(&flowField, 0, sizeof(FlowField));
+    flowField.goal = FLOW_NO_GOAL;
+    flowField.target = FLOW_NO_GOAL;
+
+    flowField.task = addTask(flowTaskStep, TASK_PRIORITY_NORMAL, FLOW_TASK_BUDGET, 0);
+}
+
+//---------------------------------------------------------------------------------
+// Allocate the field buffers in the current arena scene (5 KB) and build the
+// walkable cells from the collision map. Returns 0 when the arena is full;
+// agents then stand still and the buffers that did fit are given back.
+u8 openFlowField(void)
+{
+    u16 mark = arenaMark();
+
+    flowField.fieldA = (u8 *)arenaAlloc(FLOW_TILES);
+    flowField.fieldB = (u8 *)arenaAlloc(FLOW_TILES);
+    flowField.blank = (u8 *)arenaAlloc(FLOW_TILES);
+    flowField.queue = (u16 *)arenaAlloc(FLOW_TILES * sizeof(u16));
+    if (!flowField.fieldA || !flowField.fieldB || !flowField.blank || !flowField.queue) {
+        closeFlowField();
+        arenaRelease(mark);
+        return 0;
+    }
+
+    flowField.building = flowField.fieldA;
+    flowField.target = FLOW_NO_GOAL;
+    setFlowMap();
+    return 1;
+}
+
+//---------------------------------------------------------------------------------
+// Forget the buffers before their arena scene is popped
+void closeFlowField(void)
+{
+    flowField.fieldA = 0;
+    flowField.fieldB = 0;
+    flowField.blank = 0;
+    flowField.queue = 0;
+    flowField.building = 0;
+    flowField.published = 0;
+    flowField.goal = FLOW_NO_GOAL;
+    flowField.target = FLOW_NO_GOAL;
+    if (flowField.task) {
+        flowField.task->resume = 0;
+    }
+}
+
+//---------------------------------------------------------------------------------
+// Rebuild the walkable cells from the current collision map (call after
+// setCollisionMap). Not incremental: meant for room loads, not gameplay.
+void setFlowMap(void)
+{
+    u8 x, y;
+    u8 *cell = flowField.blank;
+
+    if (!cell) {
+        return;
+    }
+
+    for (y = 0; y < FLOW_HEIGHT; y++) {
+        for (x = 0; x < FLOW_WIDTH; x++) {
+            // isSolidTile counts tiles past the map edge as solid
+            if (isSolidTile(x, y) || isSolidTile(x + 1, y) ||
+                isSolidTile(x, y + 1) || isSolidTile(x + 1, y + 1)) {
+                *cell++ = FLOW_BLOCKED;
+            } else {
+                *cell++ = FLOW_NONE;
+            }
+        }
+    }
+
+    // Drop the old field and restart any build in progress on the new map
+    flowField.published = 0;
+    flowField.goal = FLOW_NO_GOAL;
+    if (flowField.task) {
+        flowField.task->resume = 0;
+    }
+}
+
+//---------------------------------------------------------------------------------
+// Request a field toward the agent-sized box at (x, y). Cheap: call every tick;
+// the worker only rebuilds when the goal cell changes.
+void setFlowGoal(s16 x, s16 y)
+{
+    if (x < 0 || y < 0 || (x >> 3) >= FLOW_WIDTH || (y >> 3) >= FLOW_HEIGHT) {
+        return;
+    }
+
+    // A box that fits in the map always fits at its top-left tile
+    flowField.target = ((u16)(y >> 3) << FLOW_WIDTH_SHIFT) | (x >> 3);
+}
+
+//---------------------------------------------------------------------------------
+// Step toward the goal for an agent whose box top-left is at (x, y): one table
+// read. FLOW_NONE until the first field is published.
+u8 flowDirection(s16 x, s16 y)
+{
+    u8 dir;
+
+    if (!flowField.published || x < 0 || y < 0 || (x >> 3) >= FLOW_WIDTH || (y >> 3) >= FLOW_HEIGHT) {
+        return FLOW_NONE;
+    }
+    dir = flowField.published[((u16)(y >> 3) << FLOW_WIDTH_SHIFT) | (x >> 3)];
+    return dir == FLOW_BLOCKED ? FLOW_NONE : dir;
+}
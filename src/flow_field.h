@@ -0,0 +1,77 @@
+/*---------------------------------------------------------------------------------
+
+
+    Chronic Echo - Flow Field Header
+    -- Incremental BFS toward the player over the collision grid
+
+
+---------------------------------------------------------------------------------*/
+#ifndef FLOW_FIELD_H
+#define FLOW_FIELD_H
+
+#include <snes.h>
+
+#include "tasks.h"
+
+//---------------------------------------------------------------------------------
+// Field grid: one cell per 8x8 tile, 32x32 so an index is (y << 5) | x. A
+// cell is the top-left tile of a 16x16 agent and is only walkable when all
+// four tiles under the agent are open, so agents never clip a wall corner.
+#define FLOW_WIDTH_SHIFT 5
+#define FLOW_WIDTH (1 << FLOW_WIDTH_SHIFT)
+#define FLOW_HEIGHT 32
+#define FLOW_TILES (FLOW_WIDTH * FLOW_HEIGHT)
+#define FLOW_AGENT_TILES 2
+
+//---------------------------------------------------------------------------------
+// Cell values: the step toward the goal
+#define FLOW_NONE 0         // Not reached (unreachable once the field is done)
+#define FLOW_LEFT 1
+#define FLOW_RIGHT 2
+#define FLOW_UP 3
+#define FLOW_DOWN 4
+#define FLOW_GOAL 5
+#define FLOW_BLOCKED 0xFF   // Agent does not fit here
+
+#define FLOW_NO_GOAL 0xFFFF
+
+//---------------------------------------------------------------------------------
+// Worker pacing: cells expanded between yields, bytes cleared between yields,
+// and scanlines the task may use per frame
+#define FLOW_CELLS_PER_STEP 16
+#define FLOW_CLEAR_CHUNK 128
+#define FLOW_TASK_BUDGET 48
+
+//---------------------------------------------------------------------------------
+// Flow Field Structure. The buffers are scene allocations in the $7F arena
+// (openFlowField); all are 0 while no field is open.
+typedef struct {
+    u8 *fieldA;                 // FLOW_TILES cells each
+    u8 *fieldB;
+    u8 *blank;                  // FLOW_NONE / FLOW_BLOCKED per cell (from setFlowMap)
+    u16 *queue;                 // BFS queue: every cell is queued at most once
+    u8 *published;              // Finished field agents read (0 = none yet)
+    u8 *building;               // Field the worker is filling
+    u16 queueHead;
+    u16 queueTail;
+    u16 goal;                   // Goal cell of the published field
+    u16 target;                 // Goal cell requested by setFlowGoal()
+    u16 buildGoal;              // Goal cell of the field being built
+    u16 builds;                 // Fields published
+    Task *task;
+} FlowField;
+
+//---------------------------------------------------------------------------------
+// External declarations
+extern FlowField flowField;
+
+//---------------------------------------------------------------------------------
+// Function declarations
+void initFlowField(void);
+u8 openFlowField(void);
+void closeFlowField(void);
+void setFlowMap(void);
+void setFlowGoal(s16 x, s16 y);
+u8 flowDirection(s16 x, s16 y);
+
+#endif // FLOW_FIELD_H
@@ -0,0 +1,74 @@
+/*---------------------------------------------------------------------------------
+
+
+    Chronic Echo - Game Loop Timing Implementation
+    -- Fixed 60 Hz logic ticks decoupled from VBlanks, with lag catch-up
+
+
+---------------------------------------------------------------------------------*/
+#include <snes.h>
+
+#include "game_loop.h"
+
+//---------------------------------------------------------------------------------
+// Global loop timing state
+GameLoop gameLoop;
+
+//---------------------------------------------------------------------------------
+void initGameLoop(void)
+{
+    gameLoop.tick = 0;
+    gameLoop.totalLagFrames = 0;
+    gameLoop.droppedTicks = 0;
+    resyncGameLoop();
+}
+
+//---------------------------------------------------------------------------------
+// Forget elapsed VBlanks. Call after deliberate waits (screen clears, loads)
+// so they are not replayed as catch-up ticks.
+void resyncGameLoop(void)
+{
+    gameLoop.lastVblank = snes_vblank_count;
+    gameLoop.accumulator = 0;
+    gameLoop.ticksThisFrame = 0;
+    gameLoop.lagFrames = 0;
+}
+
+//---------------------------------------------------------------------------------
+// Call once per loop iteration, before any logic. Returns how many logic
+// ticks to run before the single draw of this iteration.
+u8 beginGameLoopFrame(void)
+{
+    u16 now = snes_vblank_count;
+    u16 elapsed = now - gameLoop.lastVblank;
+    u8 ticks = 0;
+
+    gameLoop.lastVblank = now;
+    gameLoop.lagFrames = elapsed > 1 ? (u8)(elapsed > 255 ? 255 : elapsed - 1) : 0;
+    gameLoop.totalLagFrames += gameLoop.lagFrames;
+
+    // Each VBlank lasts 1/fps s and owes 60/fps ticks: add 60 per VBlank,
+    // pay fps per tick (NTSC: exactly 1 tick, PAL: 1.2 ticks on average)
+    if (elapsed > GAME_LOOP_MAX_TICKS) {
+        gameLoop.droppedTicks += elapsed - GAME_LOOP_MAX_TICKS;
+        elapsed = GAME_LOOP_MAX_TICKS;
+    }
+    gameLoop.accumulator += elapsed * TICKS_PER_SECOND;
+    while (gameLoop.accumulator >= snes_fps) {
+        gameLoop.accumulator -= snes_fps;
+        if (ticks < GAME_LOOP_MAX_TICKS) {
+            ticks++;
+        } else {
+            gameLoop.droppedTicks++;
+        }
+    }
+
+    gameLoop.ticksThisFrame = ticks;
+    return ticks;
+}
+
+//---------------------------------------------------------------------------------
+void endGameLoopTick(void)
+{
+    gameLoop.tick++;
+}
@@ -0,0 +1,54 @@
+/*---------------------------------------------------------------------------------
+
+
+    Chronic Echo - Game Loop Timing Header
+    -- Fixed 60 Hz logic ticks decoupled from VBlanks, with lag catch-up
+
+
+---------------------------------------------------------------------------------*/
+#ifndef GAME_LOOP_H
+#define GAME_LOOP_H
+
+#include <snes.h>
+
+//---------------------------------------------------------------------------------
+// Logic rate. All gameplay timers count ticks, never VBlanks: NTSC runs one
+// tick per VBlank, PAL runs 6 ticks per 5 VBlanks.
+#define TICKS_PER_SECOND 60
+#define SECONDS_TO_TICKS(s) ((s) * TICKS_PER_SECOND)
+
+//---------------------------------------------------------------------------------
+// Catch-up limit: after a long stall the game slows down instead of running
+// a burst of ticks that would itself overrun the next VBlank
+#define GAME_LOOP_MAX_TICKS 4
+
+//---------------------------------------------------------------------------------
+// VRAM bytes the per-frame flushes may DMA in one VBlank (about 10 scanlines
+// of an NTSC VBlank's ~37). flushObjCache() goes first and textFlush() gets
+// what it leaves.
+#define VBLANK_DMA_BYTES 1536
+
+//---------------------------------------------------------------------------------
+// Loop Timing Structure
+typedef struct {
+    u16 tick;           // Logic ticks run since initGameLoop()
+    u16 lastVblank;     // snes_vblank_count at the previous beginGameLoopFrame()
+    u16 accumulator;    // Owed tick time, in 1/(60 * fps) s units
+    u8 ticksThisFrame;  // Ticks scheduled by the last beginGameLoopFrame()
+    u8 lagFrames;       // VBlanks missed by the last loop iteration
+    u16 totalLagFrames; // VBlanks missed since initGameLoop()
+    u16 droppedTicks;   // Ticks discarded by the catch-up limit
+} GameLoop;
+
+//---------------------------------------------------------------------------------
+// External declarations
+extern GameLoop gameLoop;
+
+//---------------------------------------------------------------------------------
+// Function declarations
+void initGameLoop(void);
+void resyncGameLoop(void);
+u8 beginGameLoopFrame(void);
+void endGameLoopTick(void);
+
+#endif // GAME_LOOP_H
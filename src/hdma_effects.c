@@ -0,0 +1,326 @@
+/*---------------------------------------------------------------------------------
+
+
+    Chronic Echo - HDMA Effect Layer Implementation
+    -- Per-scanline screen transitions and time-warp distortion
+
+
+---------------------------------------------------------------------------------*/
+#include <snes.h>
+
+#include "hdma_effects.h"
+#include "hw_registers.h"
+
+//---------------------------------------------------------------------------------
+// HDMA table constants
+#define HDMA_ENTRY_SIZE 3          // Line count byte + two data bytes
+#define HDMA_REPEAT 0x80           // Line count flag: write on every line
+#define HDMA_WINDOW_EMPTY_LEFT 255 // Left > right disables the window on a line
+#define HDMA_WINDOW_EMPTY_RIGHT 0
+
+// Color window clipping (CGWSEL bits 7-6) and window 1 selection (WOBJSEL bits 5-4)
+#define CGWSEL_CLIP_INSIDE 0x80
+#define CGWSEL_CLIP_OUTSIDE 0x40
+#define WOBJSEL_COLOR_W1 0x20
+
+#define HDMA_WINDOW_BIT (1 << HDMA_WINDOW_CHANNEL)
+#define HDMA_SCROLL_BIT (1 << HDMA_SCROLL_CHANNEL)
+
+//---------------------------------------------------------------------------------
+// Global effect state
+HdmaEffectState hdmaEffects;
+
+//---------------------------------------------------------------------------------
+// Per-scanline tables, built once by initHdmaEffects()
+u8 hdmaWipeTable[HDMA_WIPE_ENTRIES * HDMA_ENTRY_SIZE + 1];
+u8 hdmaIrisTables[HDMA_IRIS_STEPS][HDMA_IRIS_TABLE_SIZE];
+u8 hdmaWarpTable[HDMA_WARP_ENTRIES * HDMA_ENTRY_SIZE + 1];
+
+//---------------------------------------------------------------------------------
+// Low 16 bits of each table address (all tables share one WRAM bank)
+static u16 wipeTableAddress;
+static u16 irisTableAddress[HDMA_IRIS_STEPS];
+static u16 warpTableAddress;
+static u8 tableBank;
+
+//---------------------------------------------------------------------------------
+// One period of the warp wave, 6 pixels peak
+static const s8 warpWave[HDMA_WARP_PERIOD] = {
+    0, 1, 2, 3, 4, 5, 6, 6, 6, 6, 6, 5, 4, 3, 2, 1,
+    0, -1, -2, -3, -4, -5, -6, -6, -6, -6, -6, -5, -4, -3, -2, -1
+};
+
+//---------------------------------------------------------------------------------
+// Integer square root for the iris half-widths (init only)
+static u16 isqrt16(u16 value)
+{
+    u16 root = 0;
+    u16 bit = 0x4000;
+
+    while (bit > value) {
+        bit >>= 2;
+    }
+
+    while (bit != 0) {
+        if (value >= root + bit) {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return root;
+}
+
+//---------------------------------------------------------------------------------
+// Diagonal wipe: entry j covers 2 lines and blacks out x <= EDGE_START - 2j
+static void buildWipeTable(void)
+{
+    u8 *p = hdmaWipeTable;
+    u16 j;
+    s16 edge;
+
+    for (j = 0; j < HDMA_WIPE_ENTRIES; j++) {
+        edge = HDMA_WIPE_EDGE_START - (s16)(j << 1);
+
+        *p++ = HDMA_WIPE_LINES_PER_ENTRY;
+        if (edge < 0) {
+            *p++ = HDMA_WINDOW_EMPTY_LEFT;
+            *p++ = HDMA_WINDOW_EMPTY_RIGHT;
+        } else {
+            *p++ = 0;
+            *p++ = (edge > 255) ? 255 : (u8)edge;
+        }
+    }
+
+    *p = 0;  // End of table
+}
+
+//---------------------------------------------------------------------------------
+// Iris: window 1 spans the circle of the given radius on every line
+static void buildIrisTable(u8 *table, u16 radius)
+{
+    u8 *p = table;
+    u16 y, dy, halfWidth;
+    u16 radiusSquared = radius * radius;
+    s16 left, right;
+
+    for (y = 0; y < HDMA_SCREEN_LINES; y++) {
+        // Two repeat-mode blocks of 112 lines each
+        if (y == 0 || y == HDMA_SCREEN_LINES / 2) {
+            *p++ = HDMA_REPEAT | (HDMA_SCREEN_LINES / 2);
+        }
+
+        dy = (y < HDMA_SCREEN_CENTER_Y) ? HDMA_SCREEN_CENTER_Y - y : y - HDMA_SCREEN_CENTER_Y;
+        if (dy >= radius) {
+            *p++ = HDMA_WINDOW_EMPTY_LEFT;
+            *p++ = HDMA_WINDOW_EMPTY_RIGHT;
+            continue;
+        }
+
+        halfWidth = isqrt16(radiusSquared - dy * dy);
+        left = HDMA_SCREEN_CENTER_X - (s16)halfWidth;
+        right = HDMA_SCREEN_CENTER_X + (s16)halfWidth;
+
+        *p++ = (left < 0) ? 0 : (u8)left;
+        *p++ = (right > 255) ? 255 : (u8)right;
+    }
+
+    *p = 0;  // End of table
+}
+
+//---------------------------------------------------------------------------------
+// Warp: one line per entry, BG1 horizontal offset follows the wave
+static void buildWarpTable(void)
+{
+    u8 *p = hdmaWarpTable;
+    u16 j;
+    s16 offset;
+
+    for (j = 0; j < HDMA_WARP_ENTRIES; j++) {
+        offset = warpWave[j & (HDMA_WARP_PERIOD - 1)];
+
+        *p++ = 1;
+        *p++ = (u8)offset;
+        *p++ = (u8)((u16)offset >> 8);
+    }
+
+    *p = 0;  // End of table
+}
+
+//---------------------------------------------------------------------------------
+// Build all tables and reset effect state
+void initHdmaEffects(void)
+{
+    u8 step;
+    u32 address;
+
+    buildWipeTable();
+    buildWarpTable();
+    for (step = 0; step < HDMA_IRIS_STEPS; step++) {
+        buildIrisTable(hdmaIrisTables[step], (u16)step * HDMA_IRIS_MAX_RADIUS / (HDMA_IRIS_STEPS - 1));
+    }
+
+    // Resolve table addresses once so per-frame updates are single 16-bit writes
+    address = (u32)hdmaWipeTable;
+    wipeTableAddress = (u16)address;
+    tableBank = (u8)(address >> 16);
+    warpTableAddress = (u16)(u32)hdmaWarpTable;
+    for (step = 0; step < HDMA_IRIS_STEPS; step++) {
+        irisTableAddress[step] = (u16)(u32)hdmaIrisTables[step];
+    }
+
+    hdmaEffects.transition = HDMA_TRANSITION_NONE;
+    hdmaEffects.transitionDone = 0;
+    hdmaEffects.step = 0;
+    hdmaEffects.stepTimer = 0;
+    hdmaEffects.warpActive = 0;
+    hdmaEffects.warpPhase = 0;
+    hdmaEffects.channelMask = 0;
+    hdmaEffects.colorMathSelect = 0;
+
+    HW_HDMAEN = 0;
+}
+
+//---------------------------------------------------------------------------------
+// Start a window-based screen transition (takes effect on the next update)
+void startHdmaTransition(u8 transition)
+{
+    hdmaEffects.transition = transition;
+    hdmaEffects.transitionDone = 0;
+    hdmaEffects.stepTimer = HDMA_IRIS_FRAMES_PER_STEP;
+
+    if (transition == HDMA_TRANSITION_WIPE) {
+        hdmaEffects.step = HDMA_WIPE_SPAN;
+    } else if (transition == HDMA_TRANSITION_IRIS_CLOSE) {
+        hdmaEffects.step = HDMA_IRIS_STEPS - 1;
+    } else {
+        hdmaEffects.step = 0;
+    }
+}
+
+//---------------------------------------------------------------------------------
+// Stop the current transition and release the window channel
+void stopHdmaTransition(void)
+{
+    hdmaEffects.transition = HDMA_TRANSITION_NONE;
+    hdmaEffects.transitionDone = 0;
+}
+
+//---------------------------------------------------------------------------------
+// Has the current transition reached its final frame?
+u8 isHdmaTransitionDone(void)
+{
+    return hdmaEffects.transitionDone;
+}
+
+//---------------------------------------------------------------------------------
+// Has updateHdmaEffects() enabled the transition's window channel yet? Until
+// then startHdmaTransition() has only set state and nothing is clipped.
+u8 isHdmaTransitionOnScreen(void)
+{
+    return hdmaEffects.transition != HDMA_TRANSITION_NONE && (hdmaEffects.channelMask & HDMA_WINDOW_BIT);
+}
+
+//---------------------------------------------------------------------------------
+// Start the rewind distortion
+void startTimeWarp(void)
+{
+    hdmaEffects.warpActive = 1;
+}
+
+//---------------------------------------------------------------------------------
+// Stop the rewind distortion
+void stopTimeWarp(void)
+{
+    hdmaEffects.warpActive = 0;
+}
+
+//---------------------------------------------------------------------------------
+// Set the non-clipping CGWSEL bits (e.g. sub screen addition for echoes)
+void setColorMathSelect(u8 value)
+{
+    hdmaEffects.colorMathSelect = value & 0x3F;
+    if (hdmaEffects.transition == HDMA_TRANSITION_NONE) {
+        HW_CGWSEL = hdmaEffects.colorMathSelect;
+    }
+}
+
+//---------------------------------------------------------------------------------
+// Apply effect state to the HDMA channels. Only table pointers change per
+// frame, so the cost does not depend on screen height.
+void updateHdmaEffects(void)
+{
+    u8 mask = hdmaEffects.channelMask;
+
+    // Window channel: transitions
+    if (hdmaEffects.transition != HDMA_TRANSITION_NONE) {
+        if (!(mask & HDMA_WINDOW_BIT)) {
+            HW_DMAP(HDMA_WINDOW_CHANNEL) = HW_DMAP_2REG_1WRITE;
+            HW_BBAD(HDMA_WINDOW_CHANNEL) = HW_BBAD_WH0;
+            HW_A1B(HDMA_WINDOW_CHANNEL) = tableBank;
+            HW_WOBJSEL = WOBJSEL_COLOR_W1;
+            mask |= HDMA_WINDOW_BIT;
+        }
+
+        if (hdmaEffects.transition == HDMA_TRANSITION_WIPE) {
+            HW_CGWSEL = CGWSEL_CLIP_INSIDE | hdmaEffects.colorMathSelect;
+            HW_A1T(HDMA_WINDOW_CHANNEL) = wipeTableAddress + hdmaEffects.step * HDMA_ENTRY_SIZE;
+
+            if (hdmaEffects.step == 0) {
+                hdmaEffects.transitionDone = 1;
+            } else if (hdmaEffects.step > HDMA_WIPE_SPEED) {
+                hdmaEffects.step -= HDMA_WIPE_SPEED;
+            } else {
+                hdmaEffects.step = 0;
+            }
+        } else {
+            HW_CGWSEL = CGWSEL_CLIP_OUTSIDE | hdmaEffects.colorMathSelect;
+            HW_A1T(HDMA_WINDOW_CHANNEL) = irisTableAddress[hdmaEffects.step];
+
+            if (--hdmaEffects.stepTimer == 0) {
+                hdmaEffects.stepTimer = HDMA_IRIS_FRAMES_PER_STEP;
+                if (hdmaEffects.transition == HDMA_TRANSITION_IRIS_CLOSE) {
+                    if (hdmaEffects.step == 0) {
+                        hdmaEffects.transitionDone = 1;
+                    } else {
+                        hdmaEffects.step--;
+                    }
+                } else {
+                    if (hdmaEffects.step == HDMA_IRIS_STEPS - 1) {
+                        hdmaEffects.transitionDone = 1;
+                    } else {
+                        hdmaEffects.step++;
+                    }
+                }
+            }
+        }
+    } else if (mask & HDMA_WINDOW_BIT) {
+        // Transition stopped: release the window and stop clipping
+        mask &= ~HDMA_WINDOW_BIT;
+        HW_CGWSEL = hdmaEffects.colorMathSelect;
+        HW_WOBJSEL = 0;
+    }
+
+    // Scroll channel: time warp
+    if (hdmaEffects.warpActive) {
+        if (!(mask & HDMA_SCROLL_BIT)) {
+            HW_DMAP(HDMA_SCROLL_CHANNEL) = HW_DMAP_1REG_2WRITE;
+            HW_BBAD(HDMA_SCROLL_CHANNEL) = HW_BBAD_BG1HOFS;
+            HW_A1B(HDMA_SCROLL_CHANNEL) = tableBank;
+            mask |= HDMA_SCROLL_BIT;
+        }
+
+        HW_A1T(HDMA_SCROLL_CHANNEL) = warpTableAddress + hdmaEffects.warpPhase * HDMA_ENTRY_SIZE;
+        hdmaEffects.warpPhase = (hdmaEffects.warpPhase + 1) & (HDMA_WARP_PERIOD - 1);
+    } else if (mask & HDMA_SCROLL_BIT) {
+        // Warp stopped: release the channel and put BG1 back in place
+        mask &= ~HDMA_SCROLL_BIT;
+        bgSetScroll(0, 0, 0);
+    }
+
+    hdmaEffects.channelMask = mask;
+    HW_HDMAEN = mask;
+}
@@ -0,0 +1,91 @@
+/*---------------------------------------------------------------------------------
+
+
+    Chronic Echo - HDMA Effect Layer Header
+    -- Per-scanline screen transitions and time-warp distortion
+
+
+---------------------------------------------------------------------------------*/
+#ifndef HDMA_EFFECTS_H
+#define HDMA_EFFECTS_H
+
+#include <snes.h>
+
+//---------------------------------------------------------------------------------
+// HDMA channel assignment (channel 0 is left to pvsneslib's DMA helpers)
+#define HDMA_WINDOW_CHANNEL 6      // Window 1 edges -> WH0/WH1
+#define HDMA_SCROLL_CHANNEL 7      // BG1 horizontal scroll -> BG1HOFS
+
+//---------------------------------------------------------------------------------
+// Screen geometry
+#define HDMA_SCREEN_LINES 224
+#define HDMA_SCREEN_CENTER_X 128
+#define HDMA_SCREEN_CENTER_Y 112
+
+//---------------------------------------------------------------------------------
+// Transition types
+#define HDMA_TRANSITION_NONE 0
+#define HDMA_TRANSITION_WIPE 1        // Diagonal wipe to black, left to right
+#define HDMA_TRANSITION_IRIS_CLOSE 2  // Circle shrinks to black
+#define HDMA_TRANSITION_IRIS_OPEN 3   // Circle grows out of black
+
+//---------------------------------------------------------------------------------
+// Wipe table: one entry per 2 scanlines, edge moves 1 pixel per line
+#define HDMA_WIPE_LINES_PER_ENTRY 2
+#define HDMA_WIPE_EDGE_START 480   // Edge value of entry 0 (covers the full screen)
+#define HDMA_WIPE_SPAN 241         // Entries the start pointer travels over
+#define HDMA_WIPE_ENTRIES (HDMA_WIPE_SPAN + HDMA_SCREEN_LINES / HDMA_WIPE_LINES_PER_ENTRY)
+#define HDMA_WIPE_SPEED 8          // Entries advanced per frame (~30 frames per wipe)
+
+//---------------------------------------------------------------------------------
+// Iris tables: one fixed-size repeat-mode table per radius step
+#define HDMA_IRIS_STEPS 8
+#define HDMA_IRIS_MAX_RADIUS 176   // Reaches the screen corners from the center
+#define HDMA_IRIS_FRAMES_PER_STEP 4
+#define HDMA_IRIS_TABLE_SIZE (2 * (1 + (HDMA_SCREEN_LINES / 2) * 2) + 1)
+
+//---------------------------------------------------------------------------------
+// Time-warp scroll table: one entry per scanline, phase advances 1 line per frame
+#define HDMA_WARP_PERIOD 32
+#define HDMA_WARP_ENTRIES (HDMA_SCREEN_LINES + HDMA_WARP_PERIOD)
+
+//---------------------------------------------------------------------------------
+// Effect state
+typedef struct {
+    u8 transition;      // Active HDMA_TRANSITION_* type
+    u8 transitionDone;  // Set once the transition reached its final table
+    u16 step;           // Current wipe entry or iris radius step
+    u8 stepTimer;       // Frames left before the next iris step
+    u8 warpActive;      // Is the time-warp scroll running?
+    u8 warpPhase;       // Current scanline phase of the warp table
+    u8 channelMask;     // Value last written to HDMAEN
+    u8 colorMathSelect; // CGWSEL bits owned by other systems (kept by transitions)
+} HdmaEffectState;
+
+//---------------------------------------------------------------------------------
+// Global effect state
+extern HdmaEffectState hdmaEffects;
+
+//---------------------------------------------------------------------------------
+// Function declarations
+
+// Setup
+void initHdmaEffects(void);
+
+// Screen transitions
+void startHdmaTransition(u8 transition);
+void stopHdmaTransition(void);
+u8 isHdmaTransitionDone(void);
+u8 isHdmaTransitionOnScreen(void);
+
+// Time-warp distortion
+void startTimeWarp(void);
+void stopTimeWarp(void);
+
+// Color math sharing
+void setColorMathSelect(u8 value);
+
+// Per-frame update (call right after WaitForVBlank)
+void updateHdmaEffects(void);
+
+#endif // HDMA_EFFECTS_H
@@ -0,0 +1,60 @@
+/*---------------------------------------------------------------------------------
+
+
+    Chronic Echo - Hardware Register Definitions
+    -- Direct PPU/DMA register access for effects pvsneslib does not wrap
+
+
+---------------------------------------------------------------------------------*/
+#ifndef HW_REGISTERS_H
+#define HW_REGISTERS_H
+
+#include <snes.h>
+
+//---------------------------------------------------------------------------------
+// Register access helpers
+#define HW_REG8(addr)  (*(vuint8 *)(addr))
+#define HW_REG16(addr) (*(vuint16 *)(addr))
+
+//---------------------------------------------------------------------------------
+// PPU window and color math registers
+#define HW_W12SEL   HW_REG8(0x2123)  // Window mask settings for BG1/BG2
+#define HW_W34SEL   HW_REG8(0x2124)  // Window mask settings for BG3/BG4
+#define HW_WOBJSEL  HW_REG8(0x2125)  // Window mask settings for OBJ and color window
+#define HW_WH0      HW_REG8(0x2126)  // Window 1 left position
+#define HW_WH1      HW_REG8(0x2127)  // Window 1 right position
+#define HW_TM       HW_REG8(0x212C)  // Main screen designation
+#define HW_TS       HW_REG8(0x212D)  // Sub screen designation
+#define HW_TMW      HW_REG8(0x212E)  // Window mask designation for main screen
+#define HW_CGWSEL   HW_REG8(0x2130)  // Color addition select
+#define HW_CGADSUB  HW_REG8(0x2131)  // Color math designation
+#define HW_COLDATA  HW_REG8(0x2132)  // Fixed color data
+
+//---------------------------------------------------------------------------------
+// PPU register numbers (low byte of $21xx) used as HDMA destinations
+#define HW_BBAD_BG1HOFS 0x0D
+#define HW_BBAD_WH0     0x26
+
+//---------------------------------------------------------------------------------
+// H/V counter latch and readback
+#define HW_SLHV     HW_REG8(0x2137)  // Read to latch the H/V counters
+#define HW_OPVCT    HW_REG8(0x213D)  // Vertical counter (read twice: low, then bit 8)
+#define HW_STAT78   HW_REG8(0x213F)  // PPU2 status (reading resets the OPVCT flip-flop)
+
+//---------------------------------------------------------------------------------
+// DMA / HDMA registers
+#define HW_MDMAEN   HW_REG8(0x420B)  // General purpose DMA enable
+#define HW_HDMAEN   HW_REG8(0x420C)  // HDMA channel enable
+
+#define HW_DMAP(ch)  HW_REG8(0x4300 + ((ch) << 4))   // Transfer mode
+#define HW_BBAD(ch)  HW_REG8(0x4301 + ((ch) << 4))   // B-bus destination ($21xx)
+#define HW_A1T(ch)   HW_REG16(0x4302 + ((ch) << 4))  // Table address (low 16 bits)
+#define HW_A1B(ch)   HW_REG8(0x4304 + ((ch) << 4))   // Table address bank
+
+//---------------------------------------------------------------------------------
+// HDMA transfer modes (DMAP bits 0-2)
+#define HW_DMAP_1REG_1WRITE  0x00  // 1 byte to 1 register
+#define HW_DMAP_2REG_1WRITE  0x01  // 2 bytes to 2 consecutive registers
+#define HW_DMAP_1REG_2WRITE  0x02  // 2 bytes to the same register (scroll)
+
+#endif // HW_REGISTERS_H
@@ -0,0 +1,33 @@
+/*---------------------------------------------------------------------------------
+
+
+    Chronic Echo - Item Database Implementation
+    -- ROM-resident item definitions indexed by item type
+
+
+---------------------------------------------------------------------------------*/
+#include <snes.h>
+
+#include "items.h"
+
+//---------------------------------------------------------------------------------
+// Item database (const: stays in ROM, nothing is copied into WRAM)
+const ItemDefinition itemDatabase[ITEM_TYPE_COUNT] = {
+    // name            stack  effect                    amount  icon
+    { "None",           0,    ITEM_EFFECT_NONE,          0,      0 },
+    { "Potion",         99,   ITEM_EFFECT_HEAL,          50,     2 },
+    { "Time Crystal",   99,   ITEM_EFFECT_RESTORE_TIME,  25,     3 },
+    { "Key",            9,    ITEM_EFFECT_UNLOCK,        0,      4 },
+    { "Weapon",         1,    ITEM_EFFECT_EQUIP,         0,      5 },
+    { "Armor",          1,    ITEM_EFFECT_EQUIP,         0,      6 }
+};
+
+//---------------------------------------------------------------------------------
+// Look up an item definition (invalid types map to ITEM_NONE)
+const ItemDefinition *getItemDefinition(u8 type)
+{
+    if (type >= ITEM_TYPE_COUNT) {
+        type = ITEM_NONE;
+    }
+    return &itemDatabase[type];
+}
@@ -0,0 +1,52 @@
+/*---------------------------------------------------------------------------------
+
+
+    Chronic Echo - Item Database Header
+    -- ROM-resident item definitions indexed by item type
+
+
+---------------------------------------------------------------------------------*/
+#ifndef ITEMS_H
+#define ITEMS_H
+
+#include <snes.h>
+
+//---------------------------------------------------------------------------------
+// Item types (index into itemDatabase)
+typedef enum {
+    ITEM_NONE = 0,
+    ITEM_POTION,
+    ITEM_TIME_CRYSTAL,
+    ITEM_KEY,
+    ITEM_WEAPON,
+    ITEM_ARMOR,
+    ITEM_TYPE_COUNT
+} ItemType;
+
+//---------------------------------------------------------------------------------
+// Item effects
+#define ITEM_EFFECT_NONE 0
+#define ITEM_EFFECT_HEAL 1          // Restore health by effectAmount
+#define ITEM_EFFECT_RESTORE_TIME 2  // Restore time energy by effectAmount
+#define ITEM_EFFECT_UNLOCK 3        // Opens locked doors
+#define ITEM_EFFECT_EQUIP 4         // Equippable gear
+
+//---------------------------------------------------------------------------------
+// Item Definition Structure (lives in ROM)
+typedef struct {
+    const char *name;   // Display name
+    u8 stackLimit;      // Maximum quantity per inventory slot
+    u8 effect;          // ITEM_EFFECT_* type
+    u16 effectAmount;   // Effect strength
+    u16 iconTile;       // OBJ tile number of the inventory icon
+} ItemDefinition;
+
+//---------------------------------------------------------------------------------
+// External declarations
+extern const ItemDefinition itemDatabase[ITEM_TYPE_COUNT];
+
+//---------------------------------------------------------------------------------
+// Function declarations
+const ItemDefinition *getItemDefinition(u8 type);
+
+#endif // ITEMS_H
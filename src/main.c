@@ -21,6 +21,46 @@ extern char sprites_simple, sprites_simple_pal;
 // Include our time manipulation system
 #include "time_manipulation.h"
 
+// Include our HDMA effect layer
+#include "hdma_effects.h"
+
+// Include our echo ghost renderer
+#include "echoes.h"
+
+// Include our OAM allocator
+#include "oam_alloc.h"
+
+// Include our sound effect queue
+#include "sound.h"
+
+// Include our SRAM save system
+#include "save.h"
+
+// Include our fixed-timestep loop timing
+#include "game_loop.h"
+
+// Include our cooperative task scheduler
+#include "tasks.h"
+
+// Include our tile collision layer
+#include "collision.h"
+
+// Include our OBJ tile streaming cache
+#include "obj_cache.h"
+
+// Include our shadow-tilemap text engine
+#include "text.h"
+
+// Include our bank $7F scene arena
+#include "arena.h"
+
+// Include our flow field navigation and NPC pool
+#include "flow_field.h"
+#include "npc.h"
+
+// Include our time bubbles and per-entity time scales
+#include "time_scale.h"
+
 // Screen states
 #define SCREEN_INTRO 0
 #define SCREEN_FADEOUT 1
@@ -33,14 +73,8 @@ extern char sprites_simple, sprites_simple_pal;
 //---------------------------------------------------------------------------------
 // Screen clearing helper function
 void clearScreenForTransition(void) {
-    // Clear all console text by drawing spaces over the entire console area
-    // Console is typically 32x28 characters, but we'll clear a safe area
-    int y, x;
-    for (y = 0; y < 32; y++) {
-        for (x = 0; x < 32; x += 20) {  // Draw in chunks of 20 spaces
-            consoleDrawText(x, y, "                    ");
-        }
-    }
+    // Blank the text shadow map; the rows reach VRAM over the next flushes
+    textClear();
 
     // Clear all sprites
     oamClear(0, 0);
@@ -48,6 +82,10 @@ void clearScreenForTransition(void) {
 
     // Wait for VBlank to ensure clearing takes effect
     WaitForVBlank();
+    textFlush(VBLANK_DMA_BYTES);
+
+    // The wait above is deliberate, not lag: do not catch it up
+    resyncGameLoop();
 
     // Reset any other screen state as needed
     // (Add more clearing logic here as the game grows)
@@ -67,15 +105,50 @@ int main(void)
     // Explicitly load font graphics into VRAM
     dmaCopyVram(&tilfont, 0x3000, sizeof(tilfont));
 
+    // Text goes through a WRAM shadow of the console map from here on
+    initText();
+
     // Initialize sprites
     initSprites();
+    initOamAllocator();
     initPlayer();
+    initProjectiles();
+
+    // Load the room's collision grid
+    initCollision();
+    setCollisionMap((u8 *)&collision_room0);
 
     // Initialize player character system
     initPlayerCharacter();
 
     // Initialize time manipulation system
     initPositionHistory();
+    initTimeBubbles();
+
+    // Build HDMA transition and warp tables
+    initHdmaEffects();
+
+    // Load the ghost palette for echo rendering
+    initEchoes();
+
+    // Boot the APU driver and register the sound effect bank
+    initSound();
+
+    // Background work runs as time-sliced tasks
+    initTasks();
+
+    // Per-scene buffers come from bank $7F
+    initArena();
+
+    // NPCs chase the player along a flow field rebuilt by a background task
+    initFlowField();
+    initNpcs();
+
+    // Restore battery-backed save data, if any (registers the writer task)
+    initSave();
+    if (loadGame()) {
+        getPlayerCharacterPosition(&player.x, &player.y);
+    }
 
     // Init background
     bgSetGfxPtr(0, 0x2000);
@@ -99,176 +172,301 @@ int main(void)
     // Input state for time manipulation
     u16 previousPadState = 0;
 
-    // Main game loop
+    // Set while the game screen holds an arena scene
+    u8 sceneOpen = 0;
+
+    // The rewind dialog is shown once, after the first rewind ends
+    u8 rewindSeen = 0;
+    u8 rewindDialogShown = 0;
+
+    // Main game loop: run the logic ticks owed since the last iteration, then
+    // draw once. Screen timers below count ticks, so they last the same real
+    // time on NTSC and PAL and under lag.
+    initGameLoop();
     while (1) {
-        switch (currentScreen) {
-            case SCREEN_INTRO:
-                // Intro screen: "Made with Copilot"
-                if (introFrameCount == 0) {
-                    consoleDrawText(8, 14, "Made with Copilot");
-                    consoleDrawText(8, 16, "  and pvsneslib  ");
-                    setScreenOn();
-                }
-
-                introFrameCount++;
-
-                // Wait 2.5 seconds (150 frames at 60fps, 125 at 50fps)
-                int frames_to_wait = (snes_fps == 60) ? 150 : 125;
-                if (introFrameCount >= frames_to_wait) {
-                    // Start fade out without clearing screen yet
-                    currentScreen = SCREEN_FADEOUT;
-                    fadeFrameCount = 0;
-                    brightness = 15;
-                }
-                break;
-
-            case SCREEN_FADEOUT:
-                // Fade out from intro screen
-                if (fadeFrameCount % 4 == 0 && brightness > 0) {
-                    brightness--;
-                    setBrightness(brightness);
-                }
-
-                fadeFrameCount++;
-                if (brightness <= 0) {
-                    // Clear screen during black screen transition
-                    clearScreenForTransition();
-                    currentScreen = SCREEN_BLACK;
-                    blackFrameCount = 0;
-                }
-                break;
-
-            case SCREEN_BLACK:
-                // Brief black screen
-                blackFrameCount++;
-                if (blackFrameCount >= 30) { // ~0.5 seconds at 60fps
-                    // Clear screen before title appears
-                    clearScreenForTransition();
-                    currentScreen = SCREEN_TITLE;
-                    fadeFrameCount = 0;
-                    brightness = 0;
-                }
-                break;
-
-            case SCREEN_TITLE:
-                // Title screen
-                if (fadeFrameCount == 0) {
-                    // Clear the area where "Made with Copilot" was displayed
-                    consoleDrawText(8, 14, "                    ");
-                    consoleDrawText(9, 10, "CHRONIC ECHOES");
-                    consoleDrawText(10, 24, "PRESS START");
-                    setScreenOn();
-                }
-
-                // Fade in title screen
-                if (fadeFrameCount % 4 == 0 && brightness < 15) {
-                    brightness++;
-                    setBrightness(brightness);
-                }
-
-                // Check for start button to begin game
-                if (padsCurrent(0) & KEY_START) {
-                    // Start fade out before game
-                    currentScreen = SCREEN_TITLE_FADEOUT;
-                    fadeFrameCount = 0;
-                }
-
-                fadeFrameCount++;
-                break;
-
-            case SCREEN_TITLE_FADEOUT:
-                // Fade out from title screen
-                if (fadeFrameCount % 4 == 0 && brightness > 0) {
-                    brightness--;
-                    setBrightness(brightness);
-                }
-
-                fadeFrameCount++;
-                if (brightness <= 0) {
-                    // Clear screen before game starts
-                    clearScreenForTransition();
-                    currentScreen = SCREEN_GAME;
-                    fadeFrameCount = 0;
-                    brightness = 0;
-                }
-                break;
-
-            case SCREEN_GAME:
-                // Game screen - fade in then update and draw sprites
-                if (fadeFrameCount == 0) {
-                    // Initialize game content
-                    updatePlayer();
-                    drawPlayer();
-                    setScreenOn();
-                    brightness = 0;
-                }
-
-                // Fade in game screen
-                if (fadeFrameCount % 4 == 0 && brightness < 15) {
-                    brightness++;
-                    setBrightness(brightness);
-                }
-
-                fadeFrameCount++;
-
-                // Only handle game input after fade in is complete
-                if (brightness >= 15) {
-                    // Handle input for player movement
-                    if (padsCurrent(0) & KEY_LEFT) {
-                        movePlayer(-2, 0);
+        u8 ticks = beginGameLoopFrame();
+
+        for (; ticks > 0; ticks--) {
+            switch (currentScreen) {
+                case SCREEN_INTRO:
+                    // Intro screen: "Made with Copilot"
+                    if (introFrameCount == 0) {
+                        textDrawString(8, 14, "Made with Copilot");
+                        textDrawString(8, 16, "  and pvsneslib  ");
+                        setScreenOn();
+                    }
+
+                    introFrameCount++;
+
+                    // Wait 2.5 seconds
+                    if (introFrameCount >= SECONDS_TO_TICKS(5) / 2) {
+                        // Start fade out without clearing screen yet
+                        currentScreen = SCREEN_FADEOUT;
+                        fadeFrameCount = 0;
+                        brightness = 15;
+                    }
+                    break;
+
+                case SCREEN_FADEOUT:
+                    // Fade out from intro screen
+                    if (fadeFrameCount % 4 == 0 && brightness > 0) {
+                        brightness--;
+                        setBrightness(brightness);
                     }
-                    if (padsCurrent(0) & KEY_RIGHT) {
-                        movePlayer(2, 0);
+
+                    fadeFrameCount++;
+                    if (brightness <= 0) {
+                        // Clear screen during black screen transition
+                        clearScreenForTransition();
+                        currentScreen = SCREEN_BLACK;
+                        blackFrameCount = 0;
+                    }
+                    break;
+
+                case SCREEN_BLACK:
+                    // Brief black screen
+                    blackFrameCount++;
+                    if (blackFrameCount >= SECONDS_TO_TICKS(1) / 2) {
+                        // Clear screen before title appears
+                        clearScreenForTransition();
+                        currentScreen = SCREEN_TITLE;
+                        fadeFrameCount = 0;
+                        brightness = 0;
                     }
-                    if (padsCurrent(0) & KEY_UP) {
-                        movePlayer(0, -2);
+                    break;
+
+                case SCREEN_TITLE:
+                    // Title screen
+                    if (fadeFrameCount == 0) {
+                        textDrawString(9, 10, "CHRONIC ECHOES");
+                        textDrawString(10, 24, "PRESS START");
+                        setScreenOn();
+                    }
+
+                    // Fade in title screen
+                    if (fadeFrameCount % 4 == 0 && brightness < 15) {
+                        brightness++;
+                        setBrightness(brightness);
                     }
-                    if (padsCurrent(0) & KEY_DOWN) {
-                        movePlayer(0, 2);
+
+                    // Check for start button to begin game
+                    if (padsCurrent(0) & KEY_START) {
+                        // Start fade out before game
+                        currentScreen = SCREEN_TITLE_FADEOUT;
+                        fadeFrameCount = 0;
+                    }
+
+                    fadeFrameCount++;
+                    break;
+
+                case SCREEN_TITLE_FADEOUT:
+                    // Close an iris on the title screen (HDMA window)
+                    if (fadeFrameCount == 0) {
+                        startHdmaTransition(HDMA_TRANSITION_IRIS_CLOSE);
                     }
 
-                    // Press B to return to title
-                    if (padsCurrent(0) & KEY_B) {
-                        currentScreen = SCREEN_GAME_FADEOUT;
+                    fadeFrameCount++;
+                    if (isHdmaTransitionDone()) {
+                        // Screen is fully clipped to black - drop brightness and release the window
+                        brightness = 0;
+                        setBrightness(brightness);
+                        stopHdmaTransition();
+
+                        // Clear screen before game starts
+                        clearScreenForTransition();
+                        currentScreen = SCREEN_GAME;
                         fadeFrameCount = 0;
+                        brightness = 0;
+                    }
+                    break;
+
+                case SCREEN_GAME:
+                    // Game screen - iris in then update and draw sprites
+                    if (fadeFrameCount == 0) {
+                        // Initialize game content
+                        updatePlayer();
+                        oamAllocBegin();
+                        drawPlayer();
+                        oamAllocCommit();
+
+                        // Scene buffers live until the game screen is left;
+                        // without a scene there is no flow field and no NPCs
+                        sceneOpen = arenaPushScene();
+                        if (sceneOpen) {
+                            openFlowField();
+                            spawnNpcsSpread(NPC_DEFAULT_COUNT);
+                        }
+
+                        // Building the walkable cells takes a few frames: not lag
+                        resyncGameLoop();
+
+                        setEchoesEnabled(1);
+                        setAutosaveEnabled(1);
+
+                        // Open an iris on the game screen (HDMA window). The
+                        // screen stays black until the window is programmed.
+                        startHdmaTransition(HDMA_TRANSITION_IRIS_OPEN);
+                    }
+
+                    // The window channel is set up at the next VBlank; only
+                    // then does the fully clipped first table make full
+                    // brightness safe
+                    if (brightness == 0 && isHdmaTransitionOnScreen()) {
+                        setScreenOn();
                         brightness = 15;
+                        setBrightness(brightness);
+                    }
+
+                    // Release the window once the iris is fully open
+                    if (hdmaEffects.transition == HDMA_TRANSITION_IRIS_OPEN && isHdmaTransitionDone()) {
+                        stopHdmaTransition();
+                    }
+
+                    fadeFrameCount++;
+
+                    // A dialog box takes the pad until it is closed
+                    if (isDialogOpen()) {
+                        updateDialog(padsCurrent(0), previousPadState);
+                    } else if (hdmaEffects.transition == HDMA_TRANSITION_NONE) {
+                        // Only handle game input after the iris is open
+                        // Handle input for player movement
+                        if (padsCurrent(0) & KEY_LEFT) {
+                            movePlayer(-2, 0);
+                        }
+                        if (padsCurrent(0) & KEY_RIGHT) {
+                            movePlayer(2, 0);
+                        }
+                        if (padsCurrent(0) & KEY_UP) {
+                            movePlayer(0, -2);
+                        }
+                        if (padsCurrent(0) & KEY_DOWN) {
+                            movePlayer(0, 2);
+                        }
+
+                        // Press A to fire a projectile in the facing direction
+                        if ((padsCurrent(0) & KEY_A) && !(previousPadState & KEY_A)) {
+                            firePlayerProjectile();
+                        }
+
+                        // Press SELECT to show the controls
+                        if ((padsCurrent(0) & KEY_SELECT) && !(previousPadState & KEY_SELECT) &&
+                            !positionHistory.isRewinding) {
+                            openDialog(DIALOG_CONTROLS);
+                        }
+
+                        // Press B to return to title
+                        if (padsCurrent(0) & KEY_B) {
+                            requestSave();
+                            setAutosaveEnabled(0);
+                            currentScreen = SCREEN_GAME_FADEOUT;
+                            fadeFrameCount = 0;
+                            brightness = 15;
+                        }
+
+                        // Handle time manipulation input (rewind moves the character, so sync both ways)
+                        setPlayerCharacterPosition(player.x, player.y);
+                        handleTimeManipulationInput(padsCurrent(0), previousPadState);
+                        getPlayerCharacterPosition(&player.x, &player.y);
+
+                        // Explain rewinding once L is let go (the box takes the pad)
+                        if (positionHistory.isRewinding) {
+                            rewindSeen = 1;
+                        } else if (rewindSeen && !rewindDialogShown) {
+                            rewindDialogShown = 1;
+                            openDialog(DIALOG_REWIND);
+                        }
                     }
 
-                    // Handle time manipulation input
-                    handleTimeManipulationInput(padsCurrent(0), previousPadState);
-                }
-
-                // Record current position for time manipulation
-                recordCurrentPosition(playerCharacter.x, playerCharacter.y);
-
-                // Update previous pad state for next frame
-                previousPadState = padsCurrent(0);
-
-                // Always update and draw sprites
-                updatePlayer();
-                drawPlayer();
-                break;
-
-            case SCREEN_GAME_FADEOUT:
-                // Fade out from game screen
-                if (fadeFrameCount % 4 == 0 && brightness > 0) {
-                    brightness--;
-                    setBrightness(brightness);
-                }
-
-                fadeFrameCount++;
-                if (brightness <= 0) {
-                    // Clear screen before title fades in
-                    clearScreenForTransition();
-                    currentScreen = SCREEN_TITLE;
-                    fadeFrameCount = 0;
-                    brightness = 0;
-                }
-                break;
+                    // Record current position for time manipulation
+                    setPlayerCharacterPosition(player.x, player.y);
+                    recordCurrentPosition(playerCharacter.x, playerCharacter.y);
+
+                    // Update previous pad state for next frame
+                    previousPadState = padsCurrent(0);
+
+                    // Update sprites; drawing happens once after the ticks.
+                    // Bubbles age first so entities see this tick's scales.
+                    // updatePlayer() reads the D-pad itself, so it waits
+                    // while a dialog box holds the pad.
+                    updateTimeBubbles();
+                    if (!isDialogOpen()) {
+                        updatePlayer();
+                    }
+                    updateProjectiles();
+
+                    // NPCs head for where the player is now (paused under a dialog)
+                    setFlowGoal(player.x, player.y);
+                    if (!isDialogOpen()) {
+                        updateNpcs();
+                    }
+                    break;
+
+                case SCREEN_GAME_FADEOUT:
+                    // Wipe the game screen to black (HDMA window)
+                    if (fadeFrameCount == 0) {
+                        stopTimeWarp();
+                        setEchoesEnabled(0);
+                        initProjectiles();
+                        clearTimeBubbles();
+                        clearNpcs();
+                        closeFlowField();
+                        if (sceneOpen) {
+                            arenaPopScene();
+                            sceneOpen = 0;
+                        }
+                        oamAllocBegin();
+                        drawPlayer();
+                        oamAllocCommit();
+                        startHdmaTransition(HDMA_TRANSITION_WIPE);
+                    }
+
+                    fadeFrameCount++;
+                    if (isHdmaTransitionDone()) {
+                        brightness = 0;
+                        setBrightness(brightness);
+                        stopHdmaTransition();
+
+                        // Clear screen before title fades in
+                        clearScreenForTransition();
+                        currentScreen = SCREEN_TITLE;
+                        fadeFrameCount = 0;
+                        brightness = 0;
+                    }
+                    break;
+            }
+            endGameLoopTick();
+        }
+
+        // Draw the game sprites once, however many ticks ran (none on an
+        // iteration that finished early, so the last frame stays on screen)
+        if (currentScreen == SCREEN_GAME && gameLoop.ticksThisFrame) {
+            oamAllocBegin();
+            drawPlayer();
+            drawProjectiles();
+            drawNpcs();
+            drawEchoes();
+            oamAllocCommit();
         }
 
+        // Spend what is left of the frame on background tasks
+        runTasks();
+
         // Wait for VBlank
         WaitForVBlank();
+
+        // Swap HDMA table pointers first: a few register writes that must
+        // land before the first visible line, however long the DMA below runs
+        updateHdmaEffects();
+
+        // Stream newly needed sprite frames into OBJ VRAM
+        flushObjCache();
+
+        // Copy changed text rows from the shadow map, within what the
+        // sprite frames left of the VBlank DMA budget
+        textFlush(VBLANK_DMA_BYTES - objCache.flushedBytes);
+
+        // Hand queued sound effects to the APU driver (never waits)
+        flushSoundQueue();
     }
 
     return 0;
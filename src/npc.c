@@ -0,0 +1,175 @@
+/*---------------------------------------------------------------------------------
+
+
+    Chronic Echo - NPC Implementation
+    -- Pool of chasing NPCs steered by the shared flow field
+
+
+---------------------------------------------------------------------------------*/
+#include <snes.h>
+#include <snes/sprite.h>
+
+#include "npc.h"
+#include "flow_field.h"
+#include "sprites.h"
+#include "oam_alloc.h"
+#include "obj_cache.h"
+
+//---------------------------------------------------------------------------------
+// Spawns keep this far (pixels, each axis) from the player's box
+#define NPC_SPAWN_CLEARANCE 32
+
+//---------------------------------------------------------------------------------
+// Global NPC pool
+Npc npcs[MAX_NPCS];
+
+//---------------------------------------------------------------------------------
+// Per-tick movement for each FLOW_* value (NONE and GOAL stand still)
+static const s8 npcStepX[FLOW_GOAL + 1] = { 0, -NPC_SPEED, NPC_SPEED, 0, 0, 0 };
+static const s8 npcStepY[FLOW_GOAL + 1] = { 0, 0, 0, -NPC_SPEED, NPC_SPEED, 0 };
+
+//---------------------------------------------------------------------------------
+// Warm tint of the sprite palette, so NPCs read apart from the player
+static u16 npcPalette[16];
+
+//---------------------------------------------------------------------------------
+static void buildNpcPalette(void)
+{
+    u16 *source = (u16 *)&sprites_simple_pal;
+    u16 color, r, g, b;
+    u8 i;
+
+    npcPalette[0] = source[0];  // Keep the transparent color
+    for (i = 1; i < 16; i++) {
+        color = source[i];
+        r = (color & 0x1F) | 0x10;
+        g = ((color >> 5) & 0x1F) >> 1;
+        b = ((color >> 10) & 0x1F) >> 2;
+        npcPalette[i] = r | (g << 5) | (b << 10);
+    }
+}
+
+//---------------------------------------------------------------------------------
+void initNpcs(void)
+{
+    clearNpcs();
+
+    buildNpcPalette();
+    dmaCopyCGram((u8 *)npcPalette, 128 + NPC_PALETTE * 16, sizeof(npcPalette));
+}
+
+//---------------------------------------------------------------------------------
+void clearNpcs(void)
+{
+    u8 i;
+
+    for (i = 0; i < MAX_NPCS; i++) {
+        npcs[i].active = 0;
+    }
+}
+
+//---------------------------------------------------------------------------------
+// Place an NPC with its box at (x, y), snapped down to the 8-pixel cell grid.
+// Returns the pool index, or NPC_NONE when the pool is full.
+u8 spawnNpc(s16 x, s16 y)
+{
+    u8 i;
+
+    for (i = 0; i < MAX_NPCS; i++) {
+        if (!npcs[i].active) {
+            npcs[i].x = x & ~7;
+            npcs[i].y = y & ~7;
+            npcs[i].dir = FLOW_NONE;
+            npcs[i].active = 1;
+            resetLocalTime(&npcs[i].time);
+            return i;
+        }
+    }
+    return NPC_NONE;
+}
+
+//---------------------------------------------------------------------------------
+// Spawn up to 'count' NPCs spread evenly over the walkable cells of the
+// current map (every Nth one), skipping cells next to the player
+void spawnNpcsSpread(u8 count)
+{
+    u16 cell, open = 0, stride, skip = 0;
+    s16 x, y;
+
+    if (!flowField.blank) {
+        return;
+    }
+    for (cell = 0; cell < FLOW_TILES; cell++) {
+        if (flowField.blank[cell] == FLOW_NONE) {
+            open++;
+        }
+    }
+    if (count == 0 || open == 0) {
+        return;
+    }
+    stride = open / count;
+
+    for (cell = 0; cell < FLOW_TILES && count > 0; cell++) {
+        if (flowField.blank[cell] != FLOW_NONE) {
+            continue;
+        }
+        if (skip) {
+            skip--;
+            continue;
+        }
+
+        x = (cell & (FLOW_WIDTH - 1)) << 3;
+        y = (cell >> FLOW_WIDTH_SHIFT) << 3;
+        if (x > player.x - NPC_SPAWN_CLEARANCE && x < player.x + NPC_SPAWN_CLEARANCE &&
+            y > player.y - NPC_SPAWN_CLEARANCE && y < player.y + NPC_SPAWN_CLEARANCE) {
+            continue;  // Take the next free cell instead
+        }
+        if (spawnNpc(x, y) == NPC_NONE) {
+            return;
+        }
+        count--;
+        skip = stride ? stride - 1 : 0;
+    }
+}
+
+//---------------------------------------------------------------------------------
+// One flow lookup per NPC on each cell boundary, then a fixed step: the cost
+// does not depend on the map or on how far away the player is. Moving between
+// two walkable cells never overlaps a wall, so no collision test is needed.
+void updateNpcs(void)
+{
+    u8 i;
+    u8 steps;
+    Npc *npc = npcs;
+
+    for (i = 0; i < MAX_NPCS; i++, npc++) {
+        // Frozen NPCs cost nothing until a bubble appears or bursts
+        if (!npc->active || LOCAL_TIME_FROZEN(&npc->time)) {
+            continue;
+        }
+        steps = advanceLocalTime(&npc->time, npc->x + (NPC_WIDTH >> 1), npc->y + (NPC_HEIGHT >> 1));
+        for (; steps > 0; steps--) {
+            if (((npc->x | npc->y) & 7) == 0) {
+                npc->dir = flowDirection(npc->x, npc->y);
+            }
+            npc->x += npcStepX[npc->dir];
+            npc->y += npcStepY[npc->dir];
+        }
+    }
+}
+
+//---------------------------------------------------------------------------------
+void drawNpcs(void)
+{
+    u8 i;
+    u16 tile = objCacheTile(SPRITE_SHEET_SIMPLE, SPRITE_FRAME_PLAYER);
+
+    if (tile == OBJ_CACHE_NO_TILE) {
+        return;
+    }
+    for (i = 0; i < MAX_NPCS; i++) {
+        if (npcs[i].active) {
+            oamAllocRequest(npcs[i].x, npcs[i].y, tile, NPC_PALETTE, NPC_SPRITE_PRIORITY, 0, OAM_CLASS_ROTATING);
+        }
+    }
+}
@@ -0,0 +1,50 @@
+/*---------------------------------------------------------------------------------
+
+
+    Chronic Echo - NPC Header
+    -- Pool of chasing NPCs steered by the shared flow field
+
+
+---------------------------------------------------------------------------------*/
+#ifndef NPC_H
+#define NPC_H
+
+#include <snes.h>
+
+#include "time_scale.h"
+
+//---------------------------------------------------------------------------------
+// NPC Constants
+#define MAX_NPCS 24
+#define NPC_NONE 0xFF
+#define NPC_DEFAULT_COUNT 16      // Spawned when the game screen starts
+#define NPC_WIDTH 16              // Same box as the flow field agent
+#define NPC_HEIGHT 16
+#define NPC_SPEED 1               // Pixels per tick (divides the 8-pixel cell)
+#define NPC_PALETTE 2             // OBJ palettes: 0 player, 1 projectiles, 4-7 echoes
+#define NPC_SPRITE_PRIORITY 2     // Behind the player (priority 3)
+
+//---------------------------------------------------------------------------------
+// NPC Structure
+typedef struct {
+    s16 x;              // Box top-left; cell aligned whenever (x | y) & 7 == 0
+    s16 y;
+    LocalTime time;     // Walks only on its own ticks inside a time bubble
+    u8 dir;             // FLOW_* step being taken (read again at each cell)
+    u8 active;          // Is this NPC in use?
+} Npc;
+
+//---------------------------------------------------------------------------------
+// External declarations
+extern Npc npcs[MAX_NPCS];
+
+//---------------------------------------------------------------------------------
+// Function declarations
+void initNpcs(void);
+void clearNpcs(void);
+u8 spawnNpc(s16 x, s16 y);
+void spawnNpcsSpread(u8 count);
+void updateNpcs(void);
+void drawNpcs(void);
+
+#endif // NPC_H
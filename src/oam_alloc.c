@@ -0,0 +1,170 @@
+/*---------------------------------------------------------------------------------
+
+
+    Chronic Echo - OAM Allocator Implementation
+    -- Per-frame sprite list with scanline overflow management
+
+
+---------------------------------------------------------------------------------*/
+#include <snes.h>
+#include <snes/sprite.h>
+#include <string.h>  // For memset
+
+#include "oam_alloc.h"
+#include "sprites.h"
+#include "obj_cache.h"
+
+//---------------------------------------------------------------------------------
+// Global allocator state
+OamAllocator oamAllocator;
+
+//---------------------------------------------------------------------------------
+// Add a sprite to the row histogram. Unless forced, nothing is reserved when
+// any covered band would exceed the per-line sprite or tile limit.
+static u8 reserveBands(OamRequest *request, u8 force)
+{
+    s16 top = request->y;
+    s16 bottom = request->y + request->size - 1;
+    u8 slivers = request->size >> 3;
+    u8 first, last, band;
+
+    if (top < 0) top = 0;
+    if (bottom > 223) bottom = 223;
+    first = (u8)(top >> OAM_BAND_SHIFT);
+    last = (u8)(bottom >> OAM_BAND_SHIFT);
+
+    if (!force) {
+        for (band = first; band <= last; band++) {
+            if (oamAllocator.bandSprites[band] >= OAM_SPRITES_PER_LINE ||
+                oamAllocator.bandTiles[band] + slivers > OAM_TILES_PER_LINE) {
+                return 0;
+            }
+        }
+    }
+
+    for (band = first; band <= last; band++) {
+        oamAllocator.bandSprites[band]++;
+        oamAllocator.bandTiles[band] += slivers;
+    }
+
+    return 1;
+}
+
+//---------------------------------------------------------------------------------
+// Write one request into an OAM slot
+static void writeSlot(u8 slot, OamRequest *request)
+{
+    u16 id = OAM_SLOT_ID(slot);
+
+    oamSet(id, (u16)request->x, (u16)request->y, request->priority,
+           request->attr & OAM_ATTR_HFLIP, (request->attr & OAM_ATTR_VFLIP) >> 1,
+           request->tile, request->palette);
+    oamSetEx(id, (request->attr & OAM_ATTR_LARGE) ? OBJ_LARGE : OBJ_SMALL, OBJ_SHOW);
+}
+
+//---------------------------------------------------------------------------------
+void initOamAllocator(void)
+{
+    memset(&oamAllocator, 0, sizeof(OamAllocator));
+}
+
+//---------------------------------------------------------------------------------
+// Start a new frame's sprite list
+void oamAllocBegin(void)
+{
+    // New draw frame for the OBJ tile cache's LRU stamps
+    objCacheBeginFrame();
+
+    oamAllocator.requestCount = 0;
+    oamAllocator.rotatingCount = 0;
+    oamAllocator.pinnedCount = 0;
+}
+
+//---------------------------------------------------------------------------------
+// Queue a sprite for this frame. Off-screen sprites are accepted but culled.
+// Returns 0 only when the request list is full.
+u8 oamAllocRequest(s16 x, s16 y, u16 tile, u8 palette, u8 priority, u8 attr, u8 spriteClass)
+{
+    OamRequest *request;
+    u8 size = (attr & OAM_ATTR_LARGE) ? OAM_LARGE_SIZE : OAM_SMALL_SIZE;
+    u8 index = oamAllocator.requestCount;
+
+    if (x <= -(s16)size || x >= 256 || y <= -(s16)size || y >= 224) {
+        return 1;  // Not visible this frame
+    }
+
+    if (index >= OAM_MAX_REQUESTS) {
+        return 0;  // List full
+    }
+
+    request = &oamAllocator.requests[index];
+    request->x = x;
+    request->y = y;
+    request->tile = tile;
+    request->palette = palette;
+    request->priority = priority;
+    request->attr = attr;
+    request->size = size;
+    oamAllocator.requestCount++;
+
+    if (spriteClass == OAM_CLASS_PINNED) {
+        oamAllocator.pinned[oamAllocator.pinnedCount++] = index;
+    } else {
+        oamAllocator.order[oamAllocator.rotatingCount++] = index;
+    }
+
+    return 1;
+}
+
+//---------------------------------------------------------------------------------
+// Build OAM for this frame: pinned sprites first, then rotating sprites from a
+// moving start offset. Sprites that would overflow a scanline band are skipped,
+// so the hardware limit is never hit and the loss rotates between objects.
+void oamAllocCommit(void)
+{
+    u8 i, index;
+    u8 slot = 0;
+    u8 dropped = 0;
+
+    memset(oamAllocator.bandSprites, 0, sizeof(oamAllocator.bandSprites));
+    memset(oamAllocator.bandTiles, 0, sizeof(oamAllocator.bandTiles));
+
+    // Pinned sprites always get the first slots
+    for (i = 0; i < oamAllocator.pinnedCount; i++) {
+        OamRequest *request = &oamAllocator.requests[oamAllocator.pinned[i]];
+        reserveBands(request, 1);
+        writeSlot(slot++, request);
+    }
+
+    // Rotating sprites, starting where the last overflow left off
+    if (oamAllocator.rotation >= oamAllocator.rotatingCount) {
+        oamAllocator.rotation = 0;
+    }
+    index = oamAllocator.rotation;
+    for (i = 0; i < oamAllocator.rotatingCount; i++) {
+        OamRequest *request = &oamAllocator.requests[oamAllocator.order[index]];
+        if (slot < OAM_MAX_SLOTS && reserveBands(request, 0)) {
+            writeSlot(slot++, request);
+        } else {
+            dropped++;
+        }
+
+        if (++index == oamAllocator.rotatingCount) {
+            index = 0;
+        }
+    }
+
+    // Only rotate while something is being dropped
+    if (dropped) {
+        oamAllocator.rotation++;
+    }
+    oamAllocator.droppedCount = dropped;
+
+    // Hide slots that were used last frame but not this one
+    for (i = slot; i < oamAllocator.usedSlots; i++) {
+        oamSetVisible(OAM_SLOT_ID(i), OBJ_HIDE);
+    }
+    oamAllocator.usedSlots = slot;
+
+    oamUpdate();
+}
@@ -0,0 +1,82 @@
+/*---------------------------------------------------------------------------------
+
+
+    Chronic Echo - OAM Allocator Header
+    -- Per-frame sprite list with scanline overflow management
+
+
+---------------------------------------------------------------------------------*/
+#ifndef OAM_ALLOC_H
+#define OAM_ALLOC_H
+
+#include <snes.h>
+
+//---------------------------------------------------------------------------------
+// Hardware limits
+#define OAM_MAX_SLOTS 128
+#define OAM_SPRITES_PER_LINE 32
+#define OAM_TILES_PER_LINE 34      // 8-pixel sprite slivers fetched per scanline
+
+//---------------------------------------------------------------------------------
+// Row histogram: 8-line bands over the visible screen
+#define OAM_BAND_SHIFT 3
+#define OAM_BANDS (224 >> OAM_BAND_SHIFT)
+
+//---------------------------------------------------------------------------------
+// Request list size
+#define OAM_MAX_REQUESTS 64
+
+//---------------------------------------------------------------------------------
+// Priority classes
+#define OAM_CLASS_PINNED 0         // Player and HUD: first in OAM, never dropped
+#define OAM_CLASS_ROTATING 1       // Echoes, projectiles, NPCs: rotated on overflow
+
+//---------------------------------------------------------------------------------
+// Attribute flags
+#define OAM_ATTR_HFLIP 0x01
+#define OAM_ATTR_VFLIP 0x02
+#define OAM_ATTR_LARGE 0x04        // Use the large OBJ size (32x32)
+
+#define OAM_SMALL_SIZE 16          // Matches OBJ_SIZE16_L32 in initSprites()
+#define OAM_LARGE_SIZE 32
+
+//---------------------------------------------------------------------------------
+// Sprite Request Structure
+typedef struct {
+    s16 x;              // Screen X position
+    s16 y;              // Screen Y position
+    u16 tile;           // Tile number (gfxoffset)
+    u8 palette;         // OBJ palette 0-7
+    u8 priority;        // BG priority 0-3
+    u8 attr;            // OAM_ATTR_* flags
+    u8 size;            // Width/height in pixels
+} OamRequest;
+
+//---------------------------------------------------------------------------------
+// Allocator State Structure
+typedef struct {
+    OamRequest requests[OAM_MAX_REQUESTS];
+    u8 order[OAM_MAX_REQUESTS];          // Rotating request indices, in submit order
+    u8 pinned[OAM_MAX_REQUESTS];         // Pinned request indices, in submit order
+    u8 requestCount;
+    u8 rotatingCount;
+    u8 pinnedCount;
+    u8 rotation;                          // Start offset into order[] this frame
+    u8 usedSlots;                         // OAM slots written by the last commit
+    u8 droppedCount;                      // Rotating sprites skipped by the last commit
+    u8 bandSprites[OAM_BANDS];            // Sprites per band
+    u8 bandTiles[OAM_BANDS];              // 8-pixel slivers per band
+} OamAllocator;
+
+//---------------------------------------------------------------------------------
+// External declarations
+extern OamAllocator oamAllocator;
+
+//---------------------------------------------------------------------------------
+// Function declarations
+void initOamAllocator(void);
+void oamAllocBegin(void);
+u8 oamAllocRequest(s16 x, s16 y, u16 tile, u8 palette, u8 priority, u8 attr, u8 spriteClass);
+void oamAllocCommit(void);
+
+#endif // OAM_ALLOC_H
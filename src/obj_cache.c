@@ -0,0 +1,188 @@
+/*---------------------------------------------------------------------------------
+
+
+    Chronic Echo - OBJ Tile Cache Implementation
+    -- LRU residency for 16x16 sprite frames streamed into OBJ VRAM
+
+
+---------------------------------------------------------------------------------*/
+#include <snes.h>
+#include <string.h>  // For memset
+
+#include "obj_cache.h"
+#include "game_loop.h"
+#include "text.h"
+
+//---------------------------------------------------------------------------------
+// Global cache state
+ObjCache objCache;
+
+// A full upload queue must leave at least one text row of the VBlank budget
+typedef char objCacheLeavesTextRow[(OBJ_CACHE_UPLOADS_PER_VBLANK * OBJ_CACHE_FRAME_BYTES
+                                    <= VBLANK_DMA_BYTES - TEXT_ROW_BYTES) ? 1 : -1];
+
+//---------------------------------------------------------------------------------
+// First OBJ tile of a slot: 8 slots per 16-tile row pair
+static u16 slotTile(u8 slot)
+{
+    return ((u16)(slot >> 3) << 5) | ((slot & 7) << 1);
+}
+
+//---------------------------------------------------------------------------------
+static void unlinkSlot(u8 slot)
+{
+    ObjCacheSlot *entry = &objCache.slots[slot];
+
+    if (entry->prev != OBJ_CACHE_NONE) {
+        objCache.slots[entry->prev].next = entry->next;
+    } else {
+        objCache.head = entry->next;
+    }
+    if (entry->next != OBJ_CACHE_NONE) {
+        objCache.slots[entry->next].prev = entry->prev;
+    } else {
+        objCache.tail = entry->prev;
+    }
+}
+
+//---------------------------------------------------------------------------------
+// Move a slot to the most recently used end and mark it in use this frame
+static void touchSlot(u8 slot)
+{
+    ObjCacheSlot *entry = &objCache.slots[slot];
+
+    entry->stamp = objCache.stamp;
+    if (objCache.head == slot) {
+        return;
+    }
+
+    unlinkSlot(slot);
+    entry->prev = OBJ_CACHE_NONE;
+    entry->next = objCache.head;
+    objCache.slots[objCache.head].prev = slot;
+    objCache.head = slot;
+}
+
+//---------------------------------------------------------------------------------
+void initObjCache(void)
+{
+    u8 slot;
+
+    memset(&objCache, 0, sizeof(ObjCache));
+    memset(objCache.resident, OBJ_CACHE_NONE, sizeof(objCache.resident));
+
+    for (slot = 0; slot < OBJ_CACHE_SLOTS; slot++) {
+        objCache.slots[slot].sheet = OBJ_CACHE_NONE;
+        objCache.slots[slot].prev = slot - 1;
+        objCache.slots[slot].next = slot + 1;
+        objCache.slots[slot].stamp = OBJ_CACHE_NEVER_USED;
+    }
+    objCache.slots[0].prev = OBJ_CACHE_NONE;
+    objCache.slots[OBJ_CACHE_SLOTS - 1].next = OBJ_CACHE_NONE;
+    objCache.head = 0;
+    objCache.tail = OBJ_CACHE_SLOTS - 1;
+}
+
+//---------------------------------------------------------------------------------
+// Register a sheet under a fixed id. Replacing a sheet drops its resident
+// frames (their slots become the next to be reused).
+void setObjSheet(u8 sheet, u8 *tiles, const u16 *frameTiles, u8 frameCount)
+{
+    u8 frame, slot;
+
+    for (frame = 0; frame < OBJ_SHEET_MAX_FRAMES; frame++) {
+        slot = objCache.resident[(sheet << OBJ_SHEET_FRAME_SHIFT) | frame];
+        if (slot != OBJ_CACHE_NONE) {
+            objCache.slots[slot].sheet = OBJ_CACHE_NONE;
+            objCache.resident[(sheet << OBJ_SHEET_FRAME_SHIFT) | frame] = OBJ_CACHE_NONE;
+        }
+    }
+
+    objCache.sheets[sheet].tiles = tiles;
+    objCache.sheets[sheet].frameTiles = frameTiles;
+    objCache.sheets[sheet].frameCount = frameCount > OBJ_SHEET_MAX_FRAMES ? OBJ_SHEET_MAX_FRAMES : frameCount;
+}
+
+//---------------------------------------------------------------------------------
+// Call once per drawn frame, before any objCacheTile() (oamAllocBegin does)
+void objCacheBeginFrame(void)
+{
+    // Wrap past the never-used mark so a fresh slot never looks drawn
+    if (++objCache.stamp == OBJ_CACHE_NEVER_USED) {
+        objCache.stamp = 0;
+    }
+}
+
+//---------------------------------------------------------------------------------
+// OAM tile number of a frame, streaming it in on first use. Returns
+// OBJ_CACHE_NO_TILE when this VBlank's upload budget is spent or every slot
+// is already on screen this frame; the sprite should be skipped and asked
+// for again next frame.
+u16 objCacheTile(u8 sheet, u8 frame)
+{
+    u16 key = ((u16)sheet << OBJ_SHEET_FRAME_SHIFT) | frame;
+    u8 slot = objCache.resident[key];
+    ObjCacheSlot *entry;
+
+    if (slot != OBJ_CACHE_NONE) {
+        touchSlot(slot);
+        return slotTile(slot);
+    }
+
+    if (frame >= objCache.sheets[sheet].frameCount || objCache.uploadCount == OBJ_CACHE_UPLOADS_PER_VBLANK) {
+        objCache.misses++;
+        return OBJ_CACHE_NO_TILE;
+    }
+
+    // Reuse the least recently used slot unless it is already drawn this frame
+    slot = objCache.tail;
+    entry = &objCache.slots[slot];
+    if (entry->stamp == objCache.stamp) {
+        objCache.misses++;
+        return OBJ_CACHE_NO_TILE;
+    }
+    if (entry->sheet != OBJ_CACHE_NONE) {
+        objCache.resident[(entry->sheet << OBJ_SHEET_FRAME_SHIFT) | entry->frame] = OBJ_CACHE_NONE;
+        objCache.evictions++;
+    }
+
+    entry->sheet = sheet;
+    entry->frame = frame;
+    objCache.resident[key] = slot;
+    objCache.uploads[objCache.uploadCount++] = slot;
+    objCache.loads++;
+
+    touchSlot(slot);
+    return slotTile(slot);
+}
+
+//---------------------------------------------------------------------------------
+// Copy queued frames into VRAM. Call in VBlank after updateHdmaEffects(), so
+// the tiles land in the same VBlank as the OAM table that uses them.
+void flushObjCache(void)
+{
+    u8 i;
+    ObjCacheSlot *entry;
+    u16 source, vram;
+    u8 *tiles;
+
+    objCache.flushedBytes = 0;
+    for (i = 0; i < objCache.uploadCount; i++) {
+        entry = &objCache.slots[objCache.uploads[i]];
+        if (entry->sheet == OBJ_CACHE_NONE) {
+            continue;  // Sheet replaced since the request
+        }
+
+        // Top-left tile of the frame: row * 512 + column * 32 bytes
+        source = objCache.sheets[entry->sheet].frameTiles[entry->frame];
+        tiles = objCache.sheets[entry->sheet].tiles +
+                ((source >> 4) << 9) + ((source & 15) << 5);
+        vram = OBJ_CACHE_VRAM + (slotTile(objCache.uploads[i]) << 4);
+
+        // Two 2-tile rows: 64 bytes each, one 16-tile row apart
+        dmaCopyVram(tiles, vram, 2 * OBJ_TILE_BYTES);
+        dmaCopyVram(tiles + OBJ_SHEET_ROW_BYTES, vram + (OBJ_SHEET_ROW_BYTES >> 1), 2 * OBJ_TILE_BYTES);
+        objCache.flushedBytes += OBJ_CACHE_FRAME_BYTES;
+    }
+    objCache.uploadCount = 0;
+}
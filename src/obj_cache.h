@@ -0,0 +1,85 @@
+/*---------------------------------------------------------------------------------
+
+
+    Chronic Echo - OBJ Tile Cache Header
+    -- LRU residency for 16x16 sprite frames streamed into OBJ VRAM
+
+
+---------------------------------------------------------------------------------*/
+#ifndef OBJ_CACHE_H
+#define OBJ_CACHE_H
+
+#include <snes.h>
+
+//---------------------------------------------------------------------------------
+// OBJ VRAM: 16 KB from word 0x4000 = 512 tiles, a 16-tile-wide grid. A slot
+// is one 16x16 frame (2x2 tiles), so the area holds 8 x 16 = 128 slots.
+#define OBJ_CACHE_VRAM 0x4000
+#define OBJ_CACHE_SLOTS 128
+#define OBJ_CACHE_NONE 0xFF
+#define OBJ_CACHE_NO_TILE 0xFFFF
+#define OBJ_CACHE_NEVER_USED 0xFFFF  // Slot stamp before first use (never a frame stamp)
+
+//---------------------------------------------------------------------------------
+// Sheets: ROM tile data in the gfx4snes OBJ layout (16 tiles per row)
+#define OBJ_CACHE_MAX_SHEETS 8
+#define OBJ_SHEET_FRAME_SHIFT 6
+#define OBJ_SHEET_MAX_FRAMES (1 << OBJ_SHEET_FRAME_SHIFT)
+#define OBJ_SHEET_ROW_BYTES 512     // 16 tiles x 32 bytes (4bpp)
+#define OBJ_TILE_BYTES 32
+
+//---------------------------------------------------------------------------------
+// Frames uploaded per VBlank (2 DMAs of 64 bytes each); misses past this wait
+// for the next frame rather than overrunning VBlank. Always leaves part of
+// VBLANK_DMA_BYTES (game_loop.h) for text.
+#define OBJ_CACHE_UPLOADS_PER_VBLANK 8
+#define OBJ_CACHE_FRAME_BYTES 128
+
+//---------------------------------------------------------------------------------
+// Sheet Structure
+typedef struct {
+    u8 *tiles;              // Tile data in ROM (0 = unused sheet)
+    const u16 *frameTiles;  // Top-left sheet tile of each 16x16 frame
+    u8 frameCount;
+} ObjSheet;
+
+//---------------------------------------------------------------------------------
+// Slot Structure (one resident frame)
+typedef struct {
+    u8 sheet;           // OBJ_CACHE_NONE = free
+    u8 frame;
+    u8 prev;            // LRU list toward the most recently used end
+    u8 next;            // LRU list toward the least recently used end
+    u16 stamp;          // Draw frame that last used this slot
+} ObjCacheSlot;
+
+//---------------------------------------------------------------------------------
+// Cache State Structure
+typedef struct {
+    ObjSheet sheets[OBJ_CACHE_MAX_SHEETS];
+    u8 resident[OBJ_CACHE_MAX_SHEETS * OBJ_SHEET_MAX_FRAMES];  // (sheet << shift) | frame -> slot
+    ObjCacheSlot slots[OBJ_CACHE_SLOTS];
+    u8 head;                                   // Most recently used slot
+    u8 tail;                                   // Least recently used slot
+    u16 stamp;                                 // Current draw frame
+    u8 uploads[OBJ_CACHE_UPLOADS_PER_VBLANK];  // Slots waiting for DMA
+    u8 uploadCount;
+    u16 flushedBytes;                          // Bytes DMA'd by the last flushObjCache()
+    u16 loads;                                 // Frames streamed in
+    u16 evictions;                             // Resident frames replaced
+    u16 misses;                                // Requests not served this frame
+} ObjCache;
+
+//---------------------------------------------------------------------------------
+// External declarations
+extern ObjCache objCache;
+
+//---------------------------------------------------------------------------------
+// Function declarations
+void initObjCache(void);
+void setObjSheet(u8 sheet, u8 *tiles, const u16 *frameTiles, u8 frameCount);
+void objCacheBeginFrame(void);
+u16 objCacheTile(u8 sheet, u8 frame);
+void flushObjCache(void);
+
+#endif // OBJ_CACHE_H
@@ -7,7 +7,7 @@
 
 ---------------------------------------------------------------------------------*/
 #include <snes.h>
-#include <string.h>  // For memset, strcpy
+#include <string.h>  // For memset
 
 #include "player.h"
 
@@ -15,17 +15,6 @@
 // Global player character instance
 PlayerCharacter playerCharacter = {0};
 
-//---------------------------------------------------------------------------------
-// Item name lookup table
-static const char* itemNames[] = {
-    "None",
-    "Potion",
-    "Time Crystal",
-    "Key",
-    "Weapon",
-    "Armor"
-};
-
 //---------------------------------------------------------------------------------
 void initPlayerCharacter(void)
 {
@@ -46,6 +35,7 @@ void initPlayerCharacter(void)
 
     // Clear inventory
     memset(playerCharacter.inventory, 0, sizeof(playerCharacter.inventory));
+    memset(playerCharacter.itemSlot, ITEM_SLOT_NONE, sizeof(playerCharacter.itemSlot));
     playerCharacter.inventoryCount = 0;
 
     // Set active
@@ -70,58 +60,72 @@ void updatePlayerCharacterStats(void)
 }
 
 //---------------------------------------------------------------------------------
+// Each item type owns at most one slot, found through itemSlot[] in O(1).
+// The stack is capped at the type's stackLimit; returns 0 if not everything fit.
 u8 addItemToCharacterInventory(ItemType type, u8 quantity)
 {
-    u8 canAdd;
-    u8 i;
-    
-    // First, try to stack with existing items of same type
-    for (i = 0; i < MAX_INVENTORY_SLOTS; i++) {
-        if (playerCharacter.inventory[i].type == type && playerCharacter.inventory[i].quantity < 99) {
-            canAdd = 99 - playerCharacter.inventory[i].quantity;
-            if (quantity <= canAdd) {
-                playerCharacter.inventory[i].quantity += quantity;
-                return 1;  // Success
-            } else {
-                playerCharacter.inventory[i].quantity = 99;
-                quantity -= canAdd;
-            }
-        }
+    Item *item;
+    u8 slot;
+    u8 room;
+
+    if (type == ITEM_NONE || type >= ITEM_TYPE_COUNT) {
+        return 0;  // Invalid item type
     }
 
-    // If we still have quantity to add, find empty slot
-    if (quantity > 0 && playerCharacter.inventoryCount < MAX_INVENTORY_SLOTS) {
-        for (i = 0; i < MAX_INVENTORY_SLOTS; i++) {
-            if (playerCharacter.inventory[i].type == ITEM_NONE) {
-                playerCharacter.inventory[i].type = type;
-                playerCharacter.inventory[i].quantity = (quantity > 99) ? 99 : quantity;
-                strcpy(playerCharacter.inventory[i].name, itemNames[type]);
-                playerCharacter.inventoryCount++;
-                return 1;  // Success
-            }
+    slot = playerCharacter.itemSlot[type];
+    if (slot == ITEM_SLOT_NONE) {
+        // New type: take the first free slot (occupied slots are packed)
+        if (playerCharacter.inventoryCount >= MAX_INVENTORY_SLOTS) {
+            return 0;  // Failed - no space
         }
+        slot = playerCharacter.inventoryCount++;
+        playerCharacter.itemSlot[type] = slot;
+        playerCharacter.inventory[slot].type = type;
+        playerCharacter.inventory[slot].quantity = 0;
+    }
+
+    item = &playerCharacter.inventory[slot];
+    room = itemDatabase[type].stackLimit - item->quantity;
+    if (quantity <= room) {
+        item->quantity += quantity;
+        return 1;  // Success
     }
 
-    return 0;  // Failed - no space or invalid operation
+    item->quantity = itemDatabase[type].stackLimit;
+    return 0;  // Stack full - only part of the quantity was added
 }
 
 //---------------------------------------------------------------------------------
+// Emptied slots are filled by moving the last occupied slot down, keeping the
+// inventory packed so adds never search for a free slot.
 u8 removeItemFromCharacterInventory(u8 slot, u8 quantity)
 {
-    if (slot >= MAX_INVENTORY_SLOTS || playerCharacter.inventory[slot].type == ITEM_NONE) {
+    Item *item;
+    u8 last;
+
+    if (slot >= playerCharacter.inventoryCount) {
         return 0;  // Invalid slot or empty
     }
 
-    if (playerCharacter.inventory[slot].quantity >= quantity) {
-        playerCharacter.inventory[slot].quantity -= quantity;
-        if (playerCharacter.inventory[slot].quantity == 0) {
-            playerCharacter.inventory[slot].type = ITEM_NONE;
-            playerCharacter.inventoryCount--;
+    item = &playerCharacter.inventory[slot];
+    if (item->quantity < quantity) {
+        return 0;  // Not enough quantity
+    }
+
+    item->quantity -= quantity;
+    if (item->quantity == 0) {
+        playerCharacter.itemSlot[item->type] = ITEM_SLOT_NONE;
+
+        last = --playerCharacter.inventoryCount;
+        if (slot != last) {
+            *item = playerCharacter.inventory[last];
+            playerCharacter.itemSlot[item->type] = slot;
         }
-        return 1;  // Success
+        playerCharacter.inventory[last].type = ITEM_NONE;
+        playerCharacter.inventory[last].quantity = 0;
     }
 
-    return 0;  // Not enough quantity
+    return 1;  // Success
 }
 
 //---------------------------------------------------------------------------------
@@ -133,6 +137,28 @@ u8 getCharacterInventorySlot(u8 index)
     return playerCharacter.inventory[index].type;
 }
 
+//---------------------------------------------------------------------------------
+// Slot holding an item type, or ITEM_SLOT_NONE
+u8 findCharacterInventorySlot(u8 type)
+{
+    if (type >= ITEM_TYPE_COUNT) {
+        return ITEM_SLOT_NONE;
+    }
+    return playerCharacter.itemSlot[type];
+}
+
+//---------------------------------------------------------------------------------
+// Quantity carried of an item type
+u8 getCharacterItemCount(u8 type)
+{
+    u8 slot = findCharacterInventorySlot(type);
+
+    if (slot == ITEM_SLOT_NONE) {
+        return 0;
+    }
+    return playerCharacter.inventory[slot].quantity;
+}
+
 //---------------------------------------------------------------------------------
 void setPlayerCharacterPosition(s16 x, s16 y)
 {
@@ -11,30 +11,21 @@
 
 #include <snes.h>
 
+#include "items.h"
+
 //---------------------------------------------------------------------------------
 // Constants
 #define MAX_INVENTORY_SLOTS 16
 #define MAX_LEVEL 99
 #define BASE_HEALTH 100
 #define BASE_TIME_ENERGY 50
+#define ITEM_SLOT_NONE 0xFF   // itemSlot[] value for types not in the inventory
 
 //---------------------------------------------------------------------------------
-// Item types (simple enum for now)
-typedef enum {
-    ITEM_NONE = 0,
-    ITEM_POTION,
-    ITEM_TIME_CRYSTAL,
-    ITEM_KEY,
-    ITEM_WEAPON,
-    ITEM_ARMOR
-} ItemType;
-
-//---------------------------------------------------------------------------------
-// Item structure
+// Item structure (name, stack limit and effect live in itemDatabase)
 typedef struct {
-    ItemType type;
+    u8 type;        // ItemType
     u8 quantity;
-    char name[16];  // Simple name storage
 } Item;
 
 //---------------------------------------------------------------------------------
@@ -53,9 +44,10 @@ typedef struct {
     s16 x;
     s16 y;
 
-    // Inventory system
+    // Inventory system (occupied slots are packed at the front)
     Item inventory[MAX_INVENTORY_SLOTS];
     u8 inventoryCount;  // Number of occupied slots
+    u8 itemSlot[ITEM_TYPE_COUNT];  // Slot holding each item type, or ITEM_SLOT_NONE
 
     // Status flags
     u8 active;          // Is player active?
@@ -72,6 +64,8 @@ void updatePlayerCharacterStats(void);
 u8 addItemToCharacterInventory(ItemType type, u8 quantity);
 u8 removeItemFromCharacterInventory(u8 slot, u8 quantity);
 u8 getCharacterInventorySlot(u8 index);
+u8 findCharacterInventorySlot(u8 type);
+u8 getCharacterItemCount(u8 type);
 void setPlayerCharacterPosition(s16 x, s16 y);
 void getPlayerCharacterPosition(s16* x, s16* y);
 u8 levelUpPlayerCharacter(void);
@@ -0,0 +1,480 @@
+/*---------------------------------------------------------------------------------
+
+
+    Chronic Echo - Save System Implementation
+    -- Battery-backed SRAM save/load with double-buffered sections
+
+
+---------------------------------------------------------------------------------*/
+#include <snes.h>
+#include <string.h>  // For memset
+
+#include "save.h"
+#include "player.h"
+#include "time_manipulation.h"
+#include "game_loop.h"
+#include "tasks.h"
+
+//---------------------------------------------------------------------------------
+// Staging buffer for the small bit-packed sections
+#define SAVE_STAGING_SIZE 32
+
+//---------------------------------------------------------------------------------
+// Bit Stream Structure (MSB first)
+typedef struct {
+    u8 *data;
+    u16 bitPos;
+} BitStream;
+
+//---------------------------------------------------------------------------------
+// Global save state
+SaveState saveState;
+
+static u8 saveStaging[SAVE_STAGING_SIZE];
+
+//---------------------------------------------------------------------------------
+// SRAM layout: copy A at the offset, copy B right after it
+static const u16 sectionOffset[SAVE_SECTION_COUNT] = {
+    0x0000,
+    2 * SAVE_STATS_COPY_SIZE,
+    2 * (SAVE_STATS_COPY_SIZE + SAVE_INVENTORY_COPY_SIZE)
+};
+static const u16 sectionCopySize[SAVE_SECTION_COUNT] = {
+    SAVE_STATS_COPY_SIZE,
+    SAVE_INVENTORY_COPY_SIZE,
+    SAVE_TIMELINE_COPY_SIZE
+};
+
+// Compile-time checks: a full history must fit one timeline copy (header,
+// 4-byte count/frame, 2 bytes per entry) or it would spill into copy B,
+// and both copies of every section must fit the SRAM
+typedef char saveTimelineFits[(sizeof(SaveSectionHeader) + 4 + 2 * POSITION_HISTORY_SIZE
+                               <= SAVE_TIMELINE_COPY_SIZE) ? 1 : -1];
+typedef char saveLayoutFits[(2 * (SAVE_STATS_COPY_SIZE + SAVE_INVENTORY_COPY_SIZE + SAVE_TIMELINE_COPY_SIZE)
+                             <= SAVE_SRAM_SIZE) ? 1 : -1];
+
+//---------------------------------------------------------------------------------
+static u8 *sectionAddress(u8 section, u8 copy)
+{
+    u16 offset = sectionOffset[section];
+
+    if (copy) {
+        offset += sectionCopySize[section];
+    }
+    return SAVE_SRAM + offset;
+}
+
+//---------------------------------------------------------------------------------
+// Fletcher-style checksum with 8-bit wrapping sums (no division)
+static u16 saveChecksum(u8 *data, u16 length)
+{
+    u8 sum1 = 0;
+    u8 sum2 = 0;
+
+    while (length--) {
+        sum1 += *data++;
+        sum2 += sum1;
+    }
+    return ((u16)sum2 << 8) | sum1;
+}
+
+//---------------------------------------------------------------------------------
+static void writeBits(BitStream *stream, u16 value, u8 count)
+{
+    while (count--) {
+        if (value & (1 << count)) {
+            stream->data[stream->bitPos >> 3] |= 0x80 >> (stream->bitPos & 7);
+        }
+        stream->bitPos++;
+    }
+}
+
+//---------------------------------------------------------------------------------
+static u16 readBits(BitStream *stream, u8 count)
+{
+    u16 value = 0;
+
+    while (count--) {
+        value <<= 1;
+        if (stream->data[stream->bitPos >> 3] & (0x80 >> (stream->bitPos & 7))) {
+            value |= 1;
+        }
+        stream->bitPos++;
+    }
+    return value;
+}
+
+//---------------------------------------------------------------------------------
+// Bit-pack the character stats into the staging buffer; returns byte length
+static u16 packStats(void)
+{
+    BitStream stream;
+
+    memset(saveStaging, 0, SAVE_STAGING_SIZE);
+    stream.data = saveStaging;
+    stream.bitPos = 0;
+
+    writeBits(&stream, playerCharacter.health, 11);
+    writeBits(&stream, playerCharacter.maxHealth, 11);
+    writeBits(&stream, playerCharacter.timeEnergy, 10);
+    writeBits(&stream, playerCharacter.maxTimeEnergy, 10);
+    writeBits(&stream, playerCharacter.experience, 16);
+    writeBits(&stream, playerCharacter.expToNext, 14);
+    writeBits(&stream, playerCharacter.level, 7);
+    writeBits(&stream, (u8)playerCharacter.x, 8);
+    writeBits(&stream, (u8)playerCharacter.y, 8);
+
+    return (stream.bitPos + 7) >> 3;
+}
+
+//---------------------------------------------------------------------------------
+static void unpackStats(u8 *data)
+{
+    BitStream stream;
+
+    stream.data = data;
+    stream.bitPos = 0;
+
+    playerCharacter.health = readBits(&stream, 11);
+    playerCharacter.maxHealth = readBits(&stream, 11);
+    playerCharacter.timeEnergy = readBits(&stream, 10);
+    playerCharacter.maxTimeEnergy = readBits(&stream, 10);
+    playerCharacter.experience = readBits(&stream, 16);
+    playerCharacter.expToNext = readBits(&stream, 14);
+    playerCharacter.level = (u8)readBits(&stream, 7);
+    playerCharacter.x = readBits(&stream, 8);
+    playerCharacter.y = readBits(&stream, 8);
+
+    if (playerCharacter.level == 0 || playerCharacter.level > MAX_LEVEL) {
+        playerCharacter.level = 1;
+    }
+    updatePlayerCharacterStats();
+}
+
+//---------------------------------------------------------------------------------
+// Bit-pack the inventory: 5-bit count, then 3-bit type + 7-bit quantity per slot
+static u16 packInventory(void)
+{
+    BitStream stream;
+    u8 i;
+
+    memset(saveStaging, 0, SAVE_STAGING_SIZE);
+    stream.data = saveStaging;
+    stream.bitPos = 0;
+
+    writeBits(&stream, playerCharacter.inventoryCount, 5);
+    for (i = 0; i < playerCharacter.inventoryCount; i++) {
+        writeBits(&stream, playerCharacter.inventory[i].type, 3);
+        writeBits(&stream, playerCharacter.inventory[i].quantity, 7);
+    }
+
+    return (stream.bitPos + 7) >> 3;
+}
+
+//---------------------------------------------------------------------------------
+static void unpackInventory(u8 *data)
+{
+    BitStream stream;
+    u8 count, i, type, quantity;
+
+    stream.data = data;
+    stream.bitPos = 0;
+
+    count = (u8)readBits(&stream, 5);
+    for (i = 0; i < count && i < MAX_INVENTORY_SLOTS; i++) {
+        type = (u8)readBits(&stream, 3);
+        quantity = (u8)readBits(&stream, 7);
+        addItemToCharacterInventory(type, quantity);
+    }
+}
+
+//---------------------------------------------------------------------------------
+// Check one copy of a section; returns 1 if complete and intact
+static u8 isCopyValid(u8 section, u8 copy)
+{
+    u8 *address = sectionAddress(section, copy);
+    SaveSectionHeader *header = (SaveSectionHeader *)address;
+
+    if (header->magic != SAVE_MAGIC || header->version != SAVE_VERSION || header->section != section) {
+        return 0;
+    }
+    if (header->length > sectionCopySize[section] - sizeof(SaveSectionHeader)) {
+        return 0;
+    }
+    return saveChecksum(address + sizeof(SaveSectionHeader), header->length) == header->checksum;
+}
+
+//---------------------------------------------------------------------------------
+// Invalidate the older copy of a section and return its payload address
+static u8 *beginSectionWrite(u8 section)
+{
+    u8 *address = sectionAddress(section, saveState.newestCopy[section] ^ 1);
+
+    // Clear the magic first: a power loss from here on leaves the newer copy intact
+    ((SaveSectionHeader *)address)->magic = 0;
+    return address + sizeof(SaveSectionHeader);
+}
+
+//---------------------------------------------------------------------------------
+// Fill in the header of the copy being written; the magic goes in last
+static void commitSectionWrite(u8 section, u16 length, u16 checksum)
+{
+    u8 copy = saveState.newestCopy[section] ^ 1;
+    SaveSectionHeader *header = (SaveSectionHeader *)sectionAddress(section, copy);
+    u16 sequence = saveState.sequence[section] + 1;
+
+    header->version = SAVE_VERSION;
+    header->section = section;
+    header->sequence = sequence;
+    header->length = length;
+    header->checksum = checksum;
+    header->magic = SAVE_MAGIC;
+
+    saveState.newestCopy[section] = copy;
+    saveState.sequence[section] = sequence;
+    saveState.lastChecksum[section] = checksum;
+    saveState.lastLength[section] = length;
+}
+
+//---------------------------------------------------------------------------------
+// Write a staged section if it differs from what was last written
+static void saveStagedSection(u8 section, u16 length)
+{
+    u16 checksum = saveChecksum(saveStaging, length);
+    u8 *payload;
+    u8 i;
+
+    if (checksum == saveState.lastChecksum[section] && length == saveState.lastLength[section]) {
+        return;  // Clean - nothing changed since the last write
+    }
+
+    payload = beginSectionWrite(section);
+    for (i = 0; i < length; i++) {
+        payload[i] = saveStaging[i];
+    }
+    commitSectionWrite(section, length, checksum);
+}
+
+//---------------------------------------------------------------------------------
+// Add bytes to the running timeline checksum (same sums as saveChecksum)
+static void writeTimelineByte(u8 value)
+{
+    *saveState.timelineCursor++ = value;
+    saveState.timelineSum1 += value;
+    saveState.timelineSum2 += saveState.timelineSum1;
+}
+
+//---------------------------------------------------------------------------------
+// Start writing the rewind timeline straight into SRAM: newest frame, count,
+// then one x/y byte pair per entry from oldest to newest (frame numbers are
+// implied). Returns 0 if the timeline is clean.
+static u8 beginTimelineWrite(void)
+{
+    u16 newest = getNewestFrame();
+
+    if (positionHistory.currentFrame == saveState.lastTimelineFrame && saveState.lastLength[SAVE_SECTION_TIMELINE]) {
+        return 0;  // Clean - no new frames recorded
+    }
+
+    saveState.timelineCursor = beginSectionWrite(SAVE_SECTION_TIMELINE);
+    saveState.timelineSum1 = 0;
+    saveState.timelineSum2 = 0;
+    saveState.timelineIndex = positionHistory.tail;
+    saveState.timelineWritten = 0;
+    saveState.timelineCount = positionHistory.count;
+    saveState.timelineStartFrame = positionHistory.currentFrame;
+
+    writeTimelineByte((u8)newest);
+    writeTimelineByte((u8)(newest >> 8));
+    writeTimelineByte((u8)saveState.timelineCount);
+    writeTimelineByte((u8)(saveState.timelineCount >> 8));
+    return 1;
+}
+
+//---------------------------------------------------------------------------------
+// Write the next SAVE_TIMELINE_CHUNK entries. Returns 1 when the write is
+// finished, committed or abandoned.
+static u8 writeTimelineChunk(void)
+{
+    u16 recorded = positionHistory.currentFrame - saveState.timelineStartFrame;
+    u16 overwritten = 0;
+    u16 i;
+
+    // Entries recorded since the write began replace the oldest ones once the
+    // buffer is full; if they reached unwritten entries, retry from scratch
+    if (saveState.timelineCount + recorded > POSITION_HISTORY_SIZE) {
+        overwritten = saveState.timelineCount + recorded - POSITION_HISTORY_SIZE;
+    }
+    if (overwritten > saveState.timelineWritten) {
+        saveState.pending |= 1 << SAVE_SECTION_TIMELINE;
+        return 1;
+    }
+
+    for (i = 0; i < SAVE_TIMELINE_CHUNK && saveState.timelineWritten < saveState.timelineCount; i++) {
+        writeTimelineByte((u8)positionHistory.entries[saveState.timelineIndex].x);
+        writeTimelineByte((u8)positionHistory.entries[saveState.timelineIndex].y);
+        if (++saveState.timelineIndex == POSITION_HISTORY_SIZE) {
+            saveState.timelineIndex = 0;
+        }
+        saveState.timelineWritten++;
+    }
+
+    if (saveState.timelineWritten < saveState.timelineCount) {
+        return 0;
+    }
+
+    commitSectionWrite(SAVE_SECTION_TIMELINE, 4 + saveState.timelineCount * 2,
+                       ((u16)saveState.timelineSum2 << 8) | saveState.timelineSum1);
+    saveState.lastTimelineFrame = saveState.timelineStartFrame;
+    return 1;
+}
+
+//---------------------------------------------------------------------------------
+static void loadTimeline(u8 *data, u16 length)
+{
+    u16 newest = data[0] | (data[1] << 8);
+    u16 count = data[2] | (data[3] << 8);
+    u16 i;
+
+    if (count > POSITION_HISTORY_SIZE || length < 4 + count * 2) {
+        return;
+    }
+
+    initPositionHistory();
+    data += 4;
+    for (i = 0; i < count; i++) {
+        positionHistory.entries[i].x = data[0];
+        positionHistory.entries[i].y = data[1];
+        positionHistory.entries[i].frameNumber = newest - (count - 1 - i);
+        data += 2;
+    }
+
+    positionHistory.count = count;
+    positionHistory.tail = 0;
+    positionHistory.head = (count == POSITION_HISTORY_SIZE) ? 0 : count;
+    positionHistory.currentFrame = newest + 1;
+    saveState.lastTimelineFrame = positionHistory.currentFrame;
+}
+
+//---------------------------------------------------------------------------------
+// Writer task: counts autosave ticks while idle, then writes one pending
+// section per step, yielding between timeline chunks
+static u8 saveTaskStep(Task *task)
+{
+    u8 section;
+
+    TASK_BEGIN(task);
+    while (1) {
+        while (!saveState.pending) {
+            if (saveState.autosaveEnabled) {
+                saveState.autosaveTimer += gameLoop.ticksThisFrame;
+                if (saveState.autosaveTimer >= SAVE_AUTOSAVE_INTERVAL) {
+                    saveState.autosaveTimer = 0;
+                    requestSave();
+                    break;
+                }
+            }
+            TASK_WAIT_FRAME(task);
+        }
+
+        for (section = 0; section < SAVE_SECTION_COUNT; section++) {
+            if (saveState.pending & (1 << section)) {
+                break;
+            }
+        }
+        saveState.pending &= ~(1 << section);
+        saveState.activeSection = section;
+
+        if (section == SAVE_SECTION_STATS) {
+            saveStagedSection(section, packStats());
+        } else if (section == SAVE_SECTION_INVENTORY) {
+            saveStagedSection(section, packInventory());
+        } else if (beginTimelineWrite()) {
+            // First chunk in the same step: the oldest entries go out before
+            // any new recording can overwrite them
+            while (!writeTimelineChunk()) {
+                TASK_YIELD(task);
+            }
+        }
+        TASK_YIELD(task);
+    }
+    TASK_END(task);
+}
+
+//---------------------------------------------------------------------------------
+// Call after initTasks()
+void initSave(void)
+{
+    memset(&saveState, 0, sizeof(SaveState));
+    saveState.task = addTask(saveTaskStep, TASK_PRIORITY_LOW, SAVE_TASK_BUDGET, 0);
+}
+
+//---------------------------------------------------------------------------------
+// Restore every section that has a valid copy. Returns a bit mask of the
+// sections loaded (0 = no save data).
+u8 loadGame(void)
+{
+    SaveSectionHeader *headerA;
+    SaveSectionHeader *headerB;
+    SaveSectionHeader *header;
+    u8 section, validA, validB, copy;
+    u8 loaded = 0;
+    u8 *payload;
+
+    for (section = 0; section < SAVE_SECTION_COUNT; section++) {
+        validA = isCopyValid(section, 0);
+        validB = isCopyValid(section, 1);
+        if (!validA && !validB) {
+            continue;
+        }
+
+        headerA = (SaveSectionHeader *)sectionAddress(section, 0);
+        headerB = (SaveSectionHeader *)sectionAddress(section, 1);
+
+        // Newest valid copy wins (sequence compare survives wraparound)
+        if (validA && validB) {
+            copy = ((s16)(headerB->sequence - headerA->sequence) > 0) ? 1 : 0;
+        } else {
+            copy = validB ? 1 : 0;
+        }
+
+        header = copy ? headerB : headerA;
+        payload = (u8 *)header + sizeof(SaveSectionHeader);
+
+        if (section == SAVE_SECTION_STATS) {
+            unpackStats(payload);
+        } else if (section == SAVE_SECTION_INVENTORY) {
+            unpackInventory(payload);
+        } else {
+            loadTimeline(payload, header->length);
+        }
+
+        saveState.newestCopy[section] = copy;
+        saveState.sequence[section] = header->sequence;
+        saveState.lastChecksum[section] = header->checksum;
+        saveState.lastLength[section] = header->length;
+        loaded |= 1 << section;
+    }
+
+    return loaded;
+}
+
+//---------------------------------------------------------------------------------
+// Queue every section; clean ones are skipped when their turn comes
+void requestSave(void)
+{
+    saveState.pending = SAVE_ALL_SECTIONS;
+}
+
+//---------------------------------------------------------------------------------
+void setAutosaveEnabled(u8 enabled)
+{
+    saveState.autosaveEnabled = enabled;
+    saveState.autosaveTimer = 0;
+}
+
+//---------------------------------------------------------------------------------
+u8 isSavePending(void)
+{
+    return saveState.pending != 0;
+}
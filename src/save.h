@@ -0,0 +1,99 @@
+/*---------------------------------------------------------------------------------
+
+
+    Chronic Echo - Save System Header
+    -- Battery-backed SRAM save/load with double-buffered sections
+
+
+---------------------------------------------------------------------------------*/
+#ifndef SAVE_H
+#define SAVE_H
+
+#include <snes.h>
+
+#include "game_loop.h"
+#include "tasks.h"
+
+//---------------------------------------------------------------------------------
+// SRAM location (LoROM bank $70). hdr.asm declares it battery-backed
+// (CARTRIDGETYPE $02, SRAMSIZE $03 = 8 KB); make validate checks the header.
+#define SAVE_SRAM ((u8 *)0x700000)
+#define SAVE_SRAM_SIZE 0x2000
+
+//---------------------------------------------------------------------------------
+// Format
+#define SAVE_MAGIC 0x4543        // "CE"
+#define SAVE_VERSION 1
+
+//---------------------------------------------------------------------------------
+// Sections (each stored twice; a write always goes to the older copy)
+#define SAVE_SECTION_STATS 0
+#define SAVE_SECTION_INVENTORY 1
+#define SAVE_SECTION_TIMELINE 2
+#define SAVE_SECTION_COUNT 3
+#define SAVE_ALL_SECTIONS ((1 << SAVE_SECTION_COUNT) - 1)
+
+// Bytes reserved per copy (header included)
+#define SAVE_STATS_COPY_SIZE 0x40
+#define SAVE_INVENTORY_COPY_SIZE 0x40
+#define SAVE_TIMELINE_COPY_SIZE 0x400
+
+//---------------------------------------------------------------------------------
+// Autosave interval (logic ticks)
+#define SAVE_AUTOSAVE_INTERVAL SECONDS_TO_TICKS(10)
+
+//---------------------------------------------------------------------------------
+// Background writer task. The timeline goes out SAVE_TIMELINE_CHUNK entries per
+// step; the chunk must exceed GAME_LOOP_MAX_TICKS so recording never catches
+// up with entries not yet written. A full timeline is POSITION_HISTORY_SIZE /
+// SAVE_TIMELINE_CHUNK steps (10 at 300 entries), so a full autosave spreads
+// over up to about 10 frames when one step fills SAVE_TASK_BUDGET.
+#define SAVE_TASK_BUDGET 16          // Scanlines per frame
+#define SAVE_TIMELINE_CHUNK 32
+
+//---------------------------------------------------------------------------------
+// Section Header Structure (written to SRAM ahead of each payload)
+typedef struct {
+    u16 magic;          // SAVE_MAGIC once the copy is complete
+    u8 version;         // SAVE_VERSION
+    u8 section;         // SAVE_SECTION_* id
+    u16 sequence;       // Incremented on every write of this section
+    u16 length;         // Payload bytes
+    u16 checksum;       // Fletcher-style checksum of the payload
+} SaveSectionHeader;
+
+//---------------------------------------------------------------------------------
+// Save System State
+typedef struct {
+    u8 pending;                               // Sections still to write (bit mask)
+    u8 autosaveEnabled;                       // Count autosave ticks?
+    u16 autosaveTimer;                        // Ticks since the last autosave
+    u8 newestCopy[SAVE_SECTION_COUNT];        // Copy (0/1) holding the newest data
+    u16 sequence[SAVE_SECTION_COUNT];         // Sequence of the newest copy
+    u16 lastChecksum[SAVE_SECTION_COUNT];     // Checksum of the data last written
+    u16 lastLength[SAVE_SECTION_COUNT];       // Length of the data last written
+    u16 lastTimelineFrame;                    // currentFrame when the timeline was saved
+    u8 activeSection;                         // Section the writer task is on
+    u8 timelineSum1;                          // Running checksum of the timeline write
+    u8 timelineSum2;
+    u16 timelineIndex;                        // Next history entry to write
+    u16 timelineWritten;                      // Entries written so far
+    u16 timelineCount;                        // Entries in this write
+    u16 timelineStartFrame;                   // currentFrame when this write began
+    u8 *timelineCursor;                       // Next SRAM byte to write
+    Task *task;                               // Writer task
+} SaveState;
+
+//---------------------------------------------------------------------------------
+// External declarations
+extern SaveState saveState;
+
+//---------------------------------------------------------------------------------
+// Function declarations
+void initSave(void);
+u8 loadGame(void);
+void requestSave(void);
+void setAutosaveEnabled(u8 enabled);
+u8 isSavePending(void);
+
+#endif // SAVE_H
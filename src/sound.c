@@ -0,0 +1,97 @@
+/*---------------------------------------------------------------------------------
+
+
+    Chronic Echo - Sound Effect System Implementation
+    -- Non-blocking SPC700 command queue for sound effects
+
+
+---------------------------------------------------------------------------------*/
+#include <snes.h>
+#include <string.h>  // For memset
+
+#include "sound.h"
+
+//---------------------------------------------------------------------------------
+// Global sound queue
+SoundQueue soundQueue;
+
+//---------------------------------------------------------------------------------
+// Sample descriptors registered with the driver
+static brrsamples sfxSamples[SFX_COUNT];
+
+//---------------------------------------------------------------------------------
+// Read a little-endian u16 from the bank directory
+static u16 readBankWord(u8 *p)
+{
+    return p[0] | (p[1] << 8);
+}
+
+//---------------------------------------------------------------------------------
+// Upload the driver and register every sample in the packed bank. This is the
+// only place that waits on the APU, and it runs once at boot.
+void initSound(void)
+{
+    u8 *bank = (u8 *)&sfxbank;
+    u8 *entry = bank + 2;
+    u8 count = bank[0];
+    u16 total = 0;
+    u8 i;
+
+    memset(&soundQueue, 0, sizeof(SoundQueue));
+
+    spcBoot();
+
+    if (count > SFX_COUNT) {
+        count = SFX_COUNT;
+    }
+
+    // Reserve APU RAM for all samples (256-byte blocks)
+    for (i = 0; i < count; i++) {
+        total += readBankWord(entry + i * 4 + 2);
+    }
+    spcAllocateSoundRegion((u8)((total + 255) >> 8));
+
+    for (i = 0; i < count; i++) {
+        spcSetSoundEntry(SOUND_DEFAULT_VOLUME, SOUND_DEFAULT_PANNING, SOUND_DEFAULT_PITCH,
+                         readBankWord(entry + 2), bank + readBankWord(entry), &sfxSamples[i]);
+        entry += 4;
+    }
+
+    soundQueue.ready = 1;
+}
+
+//---------------------------------------------------------------------------------
+// Queue a sound effect. Never waits: if the queue is full the command is dropped.
+u8 queueSoundEffect(u8 effect)
+{
+    u8 next = (soundQueue.head + 1) & (SOUND_QUEUE_SIZE - 1);
+
+    if (effect >= SFX_COUNT || next == soundQueue.tail) {
+        soundQueue.dropped++;
+        return 0;
+    }
+
+    soundQueue.commands[soundQueue.head] = effect;
+    soundQueue.head = next;
+    return 1;
+}
+
+//---------------------------------------------------------------------------------
+// Hand up to SOUND_MAX_PER_FRAME queued commands to the driver, then let it
+// service the APU ports once. Call once per frame.
+void flushSoundQueue(void)
+{
+    u8 sent = 0;
+
+    if (!soundQueue.ready) {
+        return;
+    }
+
+    while (soundQueue.tail != soundQueue.head && sent < SOUND_MAX_PER_FRAME) {
+        spcPlaySound(soundQueue.commands[soundQueue.tail]);
+        soundQueue.tail = (soundQueue.tail + 1) & (SOUND_QUEUE_SIZE - 1);
+        sent++;
+    }
+
+    spcProcess();
+}
@@ -0,0 +1,56 @@
+/*---------------------------------------------------------------------------------
+
+
+    Chronic Echo - Sound Effect System Header
+    -- Non-blocking SPC700 command queue for sound effects
+
+
+---------------------------------------------------------------------------------*/
+#ifndef SOUND_H
+#define SOUND_H
+
+#include <snes.h>
+
+//---------------------------------------------------------------------------------
+// Sound effect ids (order must match assets/audio/sfx/sfx.list)
+#define SFX_REWIND_START 0
+#define SFX_REWIND_STOP 1
+#define SFX_REWIND_FAIL 2
+#define SFX_PROJECTILE_FIRE 3
+#define SFX_COUNT 4
+
+//---------------------------------------------------------------------------------
+// Queue constants
+#define SOUND_QUEUE_SIZE 8          // Must be a power of two
+#define SOUND_MAX_PER_FRAME 2       // Commands handed to the APU driver per frame
+
+//---------------------------------------------------------------------------------
+// Playback defaults (pvsneslib pitch 4 = 8 kHz, the rate pack_sfx.py expects)
+#define SOUND_DEFAULT_VOLUME 15
+#define SOUND_DEFAULT_PANNING 8
+#define SOUND_DEFAULT_PITCH 4
+
+//---------------------------------------------------------------------------------
+// Sound Queue Structure
+typedef struct {
+    u8 commands[SOUND_QUEUE_SIZE];  // Queued SFX_* ids
+    u8 head;                        // Next slot to write
+    u8 tail;                        // Next slot to read
+    u8 dropped;                     // Commands dropped because the queue was full
+    u8 ready;                       // Driver booted and samples registered
+} SoundQueue;
+
+//---------------------------------------------------------------------------------
+// External declarations
+extern SoundQueue soundQueue;
+
+// Packed BRR bank (built by scripts/pack_sfx.py)
+extern char sfxbank, sfxbank_end;
+
+//---------------------------------------------------------------------------------
+// Function declarations
+void initSound(void);
+u8 queueSoundEffect(u8 effect);
+void flushSoundQueue(void);
+
+#endif // SOUND_H
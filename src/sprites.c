@@ -11,6 +11,11 @@
 
 // Include our header file
 #include "sprites.h"
+#include "oam_alloc.h"
+#include "sound.h"
+#include "collision.h"
+#include "obj_cache.h"
+#include "text.h"
 
 //---------------------------------------------------------------------------------
 // Global player instance
@@ -49,14 +54,27 @@ void drawPlayer(void);
 void movePlayer(s16 dx, s16 dy);
 void initProjectiles(void);
 void createProjectile(s16 x, s16 y, s16 vx, s16 vy);
+void firePlayerProjectile(void);
 void updateProjectiles(void);
 void drawProjectiles(void);
 
+//---------------------------------------------------------------------------------
+// Top-left sheet tile of each sprites_simple frame (SPRITE_FRAME_* order)
+static const u16 simpleFrameTiles[SPRITE_SIMPLE_FRAMES] = {
+    0,  // Player compass
+    1   // Projectile (right half of the compass)
+};
+
 //---------------------------------------------------------------------------------
 void initSprites(void)
 {
-    // Initialize sprite engine with 16x16 sprites, 16 colors
-    oamInitGfxSet(&sprites_simple, (&sprites_simple_end - &sprites_simple), &sprites_simple_pal, (&sprites_simple_pal_end - &sprites_simple_pal), 0, 0x4000, OBJ_SIZE16_L32);
+    // 16x16 / 32x32 sprites at VRAM 0x4000, first OBJ palette; tiles are
+    // streamed in by the OBJ cache as frames are first drawn
+    oamInitGfxAttr(OBJ_CACHE_VRAM, OBJ_SIZE16_L32);
+    dmaCopyCGram(&sprites_simple_pal, 128, (&sprites_simple_pal_end - &sprites_simple_pal));
+
+    initObjCache();
+    setObjSheet(SPRITE_SHEET_SIMPLE, &sprites_simple, simpleFrameTiles, SPRITE_SIMPLE_FRAMES);
 
     // Clear all sprites initially
     oamClear(0, 0);
@@ -115,19 +133,10 @@ void updatePlayer(void)
 //---------------------------------------------------------------------------------
 void movePlayer(s16 dx, s16 dy)
 {
-    // Store old position
-    s16 oldX = player.x;
-    s16 oldY = player.y;
-
-    // Apply movement
-    player.x += dx;
-    player.y += dy;
-
-    // Basic boundary checking (screen bounds for 16x16 sprite)
-    if (player.x < 0) player.x = 0;
-    if (player.x > 256 - 16) player.x = 256 - 16;  // 16 for 16x16 sprite
-    if (player.y < 0) player.y = 0;
-    if (player.y > 224 - 16) player.y = 224 - 16;  // 16 for 16x16 sprite
+    // Swept against the collision map one axis at a time, so the box slides
+    // along walls (the map edge is solid, which also keeps it on screen)
+    player.x += sweepCollisionX(player.x, player.y, PLAYER_WIDTH, PLAYER_HEIGHT, dx);
+    player.y += sweepCollisionY(player.x, player.y, PLAYER_WIDTH, PLAYER_HEIGHT, dy);
 
     // Position updates will be handled in drawPlayer()
 }
@@ -135,21 +144,19 @@ void movePlayer(s16 dx, s16 dy)
 //---------------------------------------------------------------------------------
 void drawPlayer(void)
 {
-    // Simple 16x16 sprite - use tile 0 for now (first tile in sprite sheet)
-    u8 tileIndex = 0;
-    
-    // Set sprite position and properties
-    oamSet(PLAYER_SPRITE_ID, player.x, player.y, 3, 0, 0, tileIndex, 0);
-    oamSetEx(PLAYER_SPRITE_ID, OBJ_SMALL, OBJ_SHOW);
-    
-    // Update OAM
-    oamUpdate();
+    // Resident tile base of the compass frame (streamed in on first use)
+    u16 tileIndex = objCacheTile(SPRITE_SHEET_SIMPLE, SPRITE_FRAME_PLAYER);
+
+    // Pinned: the player always takes the first OAM slot and is never dropped
+    if (tileIndex != OBJ_CACHE_NO_TILE) {
+        oamAllocRequest(player.x, player.y, tileIndex, 0, 3, 0, OAM_CLASS_PINNED);
+    }
     
     // Debug output (only in debug builds)
     #ifdef PVSNESLIB_DEBUG
     char buffer[32];
     sprintf(buffer, "SPRITE: X=%d Y=%d", player.x, player.y);
-    consoleDrawText(0, 21, buffer);
+    textDrawString(0, 19, buffer);  // Above the dialog box
     #endif
 }
 
@@ -158,28 +165,28 @@ void drawPlayer(void)
 void debugPlayerInfo(void)
 {
     #ifdef PVSNESLIB_DEBUG
-    consoleDrawText(0, 26, "PLAYER DEBUG:");
-    consoleDrawText(0, 27, "X:     Y:     ");
-    consoleDrawText(0, 28, "VX:    VY:    ");
+    textDrawString(0, 26, "PLAYER DEBUG:");
+    textDrawString(0, 27, "X:     Y:     ");
+    textDrawString(0, 28, "VX:    VY:    ");
 
     // Display coordinates (simple number display)
     char buffer[32];
 
     // X position
     sprintf(buffer, "%d", player.x);
-    consoleDrawText(3, 27, buffer);
+    textDrawString(3, 27, buffer);
 
     // Y position
     sprintf(buffer, "%d", player.y);
-    consoleDrawText(9, 27, buffer);
+    textDrawString(9, 27, buffer);
 
     // X velocity
     sprintf(buffer, "%d", player.vx);
-    consoleDrawText(4, 28, buffer);
+    textDrawString(4, 28, buffer);
 
     // Y velocity
     sprintf(buffer, "%d", player.vy);
-    consoleDrawText(10, 28, buffer);
+    textDrawString(10, 28, buffer);
     #endif
 }
 
@@ -189,7 +196,6 @@ void initProjectiles(void)
     int i;
     for (i = 0; i < MAX_PROJECTILES; i++) {
         projectiles[i].active = 0;
-        projectiles[i].spriteId = PLAYER_SPRITE_ID + 1 + i; // Reserve sprite IDs after player
     }
 }
 
@@ -204,43 +210,74 @@ void createProjectile(s16 x, s16 y, s16 vx, s16 vy)
             projectiles[i].vx = vx;
             projectiles[i].vy = vy;
             projectiles[i].active = 1;
+            resetLocalTime(&projectiles[i].time);
 
-            // Set up the projectile's OAM entry
-            // Use tile 1 (loaded at VRAM 0x4020) and palette 1 (loaded at CGram 144)
-            oamSet(projectiles[i].spriteId,
-                   projectiles[i].x, projectiles[i].y,
-                   3,                           // Priority (highest)
-                   0, 0,                        // No flipping
-                   1,                           // Tile offset (tile 1)
-                   1);                          // Palette (palette 1)
-
-            oamSetEx(projectiles[i].spriteId, OBJ_SMALL, OBJ_SHOW);
+            // OAM entries are assigned each frame by drawProjectiles()
+            queueSoundEffect(SFX_PROJECTILE_FIRE);
             break;
         }
     }
 }
 
+//---------------------------------------------------------------------------------
+// Fire a projectile from the player's center in the facing direction
+void firePlayerProjectile(void)
+{
+    s16 vx = 0;
+    s16 vy = 0;
+
+    switch (player.facing) {
+        case 0: vx = PROJECTILE_SPEED; break;   // Right
+        case 1: vx = -PROJECTILE_SPEED; break;  // Left
+        case 2: vy = -PROJECTILE_SPEED; break;  // Up
+        default: vy = PROJECTILE_SPEED; break;  // Down
+    }
+
+    createProjectile(player.x + (PLAYER_WIDTH - PROJECTILE_WIDTH) / 2,
+                     player.y + (PLAYER_HEIGHT - PROJECTILE_HEIGHT) / 2,
+                     vx, vy);
+}
+
+//---------------------------------------------------------------------------------
+// Move one projectile by one of its own ticks
+static void stepProjectile(Projectile *projectile)
+{
+    // Update position
+    projectile->x += projectile->vx;
+    projectile->y += projectile->vy;
+
+    // Check boundaries - deactivate if off screen
+    if (projectile->x < -PROJECTILE_WIDTH ||
+        projectile->x > 256 + PROJECTILE_WIDTH ||
+        projectile->y < -PROJECTILE_HEIGHT ||
+        projectile->y > 224 + PROJECTILE_HEIGHT) {
+        projectile->active = 0;
+    } else if (isSolidPoint(projectile->x + (PROJECTILE_WIDTH >> 1),
+                            projectile->y + (PROJECTILE_HEIGHT >> 1))) {
+        // Hit a wall
+        projectile->active = 0;
+    }
+}
+
 //---------------------------------------------------------------------------------
 void updateProjectiles(void)
 {
-    int i;
-    for (i = 0; i < MAX_PROJECTILES; i++) {
-        if (projectiles[i].active) {
-            // Update position
-            projectiles[i].x += projectiles[i].vx;
-            projectiles[i].y += projectiles[i].vy;
-
-            // Check boundaries - deactivate if off screen
-            if (projectiles[i].x < -PROJECTILE_WIDTH ||
-                projectiles[i].x > 256 + PROJECTILE_WIDTH ||
-                projectiles[i].y < -PROJECTILE_HEIGHT ||
-                projectiles[i].y > 224 + PROJECTILE_HEIGHT) {
-                projectiles[i].active = 0;
-                oamSetVisible(projectiles[i].spriteId, OBJ_HIDE);
-            } else {
-                // Update sprite position
-                oamSetXY(projectiles[i].spriteId, projectiles[i].x, projectiles[i].y);
-            }
+    u8 i;
+    u8 steps;
+    Projectile *projectile = projectiles;
+
+    for (i = 0; i < MAX_PROJECTILES; i++, projectile++) {
+        // Frozen projectiles cost nothing until a bubble appears or bursts
+        if (!projectile->active || LOCAL_TIME_FROZEN(&projectile->time)) {
+            continue;
+        }
+
+        // Slowed projectiles sit out some ticks; sped-up ones take several
+        steps = advanceLocalTime(&projectile->time,
+                                 projectile->x + (PROJECTILE_WIDTH >> 1),
+                                 projectile->y + (PROJECTILE_HEIGHT >> 1));
+        for (; steps > 0 && projectile->active; steps--) {
+            stepProjectile(projectile);
         }
     }
 }
@@ -249,9 +286,16 @@ void updateProjectiles(void)
 void drawProjectiles(void)
 {
     int i;
+    u16 tileIndex;
     for (i = 0; i < MAX_PROJECTILES; i++) {
         if (projectiles[i].active) {
-            oamSetVisible(projectiles[i].spriteId, OBJ_SHOW);
+            tileIndex = objCacheTile(SPRITE_SHEET_SIMPLE, SPRITE_FRAME_PROJECTILE);
+            if (tileIndex == OBJ_CACHE_NO_TILE) {
+                break;  // Not resident yet - drawn from next frame
+            }
+
+            // Palette 1, highest priority
+            oamAllocRequest(projectiles[i].x, projectiles[i].y, tileIndex, 1, 3, 0, OAM_CLASS_ROTATING);
         }
     }
 }
\ No newline at end of file
@@ -11,6 +11,8 @@
 
 #include <snes.h>
 
+#include "time_scale.h"
+
 //---------------------------------------------------------------------------------
 // Sprite Constants
 #define PLAYER_SPRITE_ID 0
@@ -22,6 +24,16 @@
 #define PROJECTILE_HEIGHT 8
 #define MAX_PROJECTILES 8
 
+// pvsneslib OAM ids are byte offsets into the OAM table (slot * 4)
+#define OAM_SLOT_ID(slot) ((slot) << 2)
+
+//---------------------------------------------------------------------------------
+// OBJ tile cache sheet ids and frames (tiles stream in through obj_cache.c)
+#define SPRITE_SHEET_SIMPLE 0
+#define SPRITE_FRAME_PLAYER 0      // Compass, top-left of sprites_simple
+#define SPRITE_FRAME_PROJECTILE 1
+#define SPRITE_SIMPLE_FRAMES 2
+
 //---------------------------------------------------------------------------------
 // Player Character Structure
 typedef struct {
@@ -42,8 +54,8 @@ typedef struct {
     s16 y;              // Y position
     s16 vx;             // X velocity
     s16 vy;             // Y velocity
+    LocalTime time;     // Moves only on its own ticks inside a time bubble
     u8 active;          // Is this projectile active?
-    u8 spriteId;        // OAM sprite ID
 } Projectile;
 
 //---------------------------------------------------------------------------------
@@ -65,6 +77,7 @@ void movePlayer(s16 dx, s16 dy);
 void debugPlayerInfo(void);
 void initProjectiles(void);
 void createProjectile(s16 x, s16 y, s16 vx, s16 vy);
+void firePlayerProjectile(void);
 void updateProjectiles(void);
 void drawProjectiles(void);
 
@@ -0,0 +1,167 @@
+/*---------------------------------------------------------------------------------
+
+
+    Chronic Echo - Cooperative Task Scheduler Implementation
+    -- Time-sliced background work with per-task scanline budgets
+
+
+---------------------------------------------------------------------------------*/
+#include <snes.h>
+#include <string.h>  // For memset
+
+#include "tasks.h"
+#include "hw_registers.h"
+
+//---------------------------------------------------------------------------------
+// Global scheduler state
+TaskScheduler taskScheduler;
+
+//---------------------------------------------------------------------------------
+// The V counter reads 225 at the start of VBlank on a 224-line screen, on
+// NTSC and PAL alike (PAL only adds lines to VBlank)
+#define TASK_VBLANK_LINE 225
+
+//---------------------------------------------------------------------------------
+// Current V counter (0 at the top of the frame)
+u16 readScanline(void)
+{
+    u16 line;
+
+    (void)HW_STAT78;    // Reset the OPVCT read flip-flop
+    (void)HW_SLHV;      // Latch H/V
+    line = HW_OPVCT;
+    line |= (HW_OPVCT & 0x01) << 8;
+    return line;
+}
+
+//---------------------------------------------------------------------------------
+// snes_fps is set at boot from the PPU's PAL/NTSC flag (STAT78 bit 4)
+static u16 linesPerFrame(void)
+{
+    return snes_fps == 50 ? TASK_LINES_PAL : TASK_LINES_NTSC;
+}
+
+//---------------------------------------------------------------------------------
+// Scanlines since VBlank after which no step starts: TASK_FRAME_MARGIN before
+// the next VBlank (200 lines on NTSC, 250 on PAL)
+static u16 frameDeadline(void)
+{
+    return linesPerFrame() - TASK_FRAME_MARGIN;
+}
+
+//---------------------------------------------------------------------------------
+// Scanlines from 'from' to 'to', across the bottom of the frame if needed
+static u16 linesBetween(u16 from, u16 to)
+{
+    return to >= from ? to - from : to + linesPerFrame() - from;
+}
+
+//---------------------------------------------------------------------------------
+// Drop freed tasks from the priority order
+static void compactOrder(void)
+{
+    u8 i, kept = 0;
+
+    for (i = 0; i < taskScheduler.count; i++) {
+        if (taskScheduler.tasks[taskScheduler.order[i]].step) {
+            taskScheduler.order[kept++] = taskScheduler.order[i];
+        }
+    }
+    taskScheduler.count = kept;
+}
+
+//---------------------------------------------------------------------------------
+void initTasks(void)
+{
+    memset(&taskScheduler, 0, sizeof(TaskScheduler));
+}
+
+//---------------------------------------------------------------------------------
+// Register a task; it first runs on the next runTasks(). Returns 0 when all
+// TASK_MAX slots are taken.
+Task *addTask(TaskStep step, u8 priority, u8 budget, void *data)
+{
+    u8 slot, i;
+    Task *task;
+
+    compactOrder();
+    for (slot = 0; slot < TASK_MAX; slot++) {
+        if (!taskScheduler.tasks[slot].step) {
+            break;
+        }
+    }
+    if (slot == TASK_MAX) {
+        return 0;
+    }
+
+    task = &taskScheduler.tasks[slot];
+    memset(task, 0, sizeof(Task));
+    task->step = step;
+    task->priority = priority;
+    task->budget = budget;
+    task->data = data;
+
+    // Insert after every task of the same or higher priority
+    for (i = taskScheduler.count; i > 0; i--) {
+        if (taskScheduler.tasks[taskScheduler.order[i - 1]].priority <= priority) {
+            break;
+        }
+        taskScheduler.order[i] = taskScheduler.order[i - 1];
+    }
+    taskScheduler.order[i] = slot;
+    taskScheduler.count++;
+
+    return task;
+}
+
+//---------------------------------------------------------------------------------
+// Safe to call from inside a step (including the task's own)
+void removeTask(Task *task)
+{
+    task->step = 0;
+}
+
+//---------------------------------------------------------------------------------
+// Call once per frame after drawing. Runs tasks in priority order; each task
+// steps until it waits, finishes, or uses its scanline budget, and unfinished
+// work resumes next frame. Nothing starts within TASK_FRAME_MARGIN lines
+// of the next VBlank.
+void runTasks(void)
+{
+    u8 i, result;
+    u16 start, used, deadline;
+    Task *task;
+
+    compactOrder();
+    deadline = frameDeadline();
+    taskScheduler.frameStartLine = readScanline();
+    taskScheduler.deferred = 0;
+
+    for (i = 0; i < taskScheduler.count; i++) {
+        task = &taskScheduler.tasks[taskScheduler.order[i]];
+        task->usedLines = 0;
+        if (!task->step) {
+            continue;
+        }
+
+        start = readScanline();
+        if (linesBetween(TASK_VBLANK_LINE, start) >= deadline) {
+            taskScheduler.deferred = taskScheduler.count - i;
+            break;
+        }
+
+        do {
+            result = task->step(task);
+            used = linesBetween(start, readScanline());
+            if (result == TASK_DONE) {
+                task->step = 0;
+            }
+        } while (result == TASK_YIELDED && used < task->budget &&
+                 linesBetween(TASK_VBLANK_LINE, start) + used < deadline);
+
+        task->usedLines = used > 255 ? 255 : (u8)used;
+        if (task->usedLines > task->maxLines) {
+            task->maxLines = task->usedLines;
+        }
+    }
+}
@@ -0,0 +1,91 @@
+/*---------------------------------------------------------------------------------
+
+
+    Chronic Echo - Cooperative Task Scheduler Header
+    -- Time-sliced background work with per-task scanline budgets
+
+
+---------------------------------------------------------------------------------*/
+#ifndef TASKS_H
+#define TASKS_H
+
+#include <snes.h>
+
+//---------------------------------------------------------------------------------
+// Scheduler limits
+#define TASK_MAX 8
+#define TASK_NONE 0xFF
+
+// runTasks() stops starting steps once fewer than this many scanlines are
+// left before the next VBlank, leaving room for the rest of the loop
+#define TASK_FRAME_MARGIN 62
+
+// Scanlines per frame (the V counter wraps after these)
+#define TASK_LINES_NTSC 262
+#define TASK_LINES_PAL 312
+
+//---------------------------------------------------------------------------------
+// Priorities (lower runs first)
+#define TASK_PRIORITY_HIGH 0
+#define TASK_PRIORITY_NORMAL 8
+#define TASK_PRIORITY_LOW 16
+
+//---------------------------------------------------------------------------------
+// Step results
+#define TASK_YIELDED 0      // More work: run again this frame if budget remains
+#define TASK_WAITING 1      // Nothing more this frame
+#define TASK_DONE 2         // Finished: the slot is freed
+
+//---------------------------------------------------------------------------------
+// Stackless coroutine macros (protothreads). Locals do not survive a yield:
+// keep state in the Task or in the owning module's globals. A step function
+// looks like:
+//
+//     static u8 step(Task *task) {
+//         TASK_BEGIN(task);
+//         while (work) { doSome(); TASK_YIELD(task); }
+//         TASK_END(task);
+//     }
+#define TASK_BEGIN(t) switch ((t)->resume) { case 0:
+#define TASK_YIELD(t) do { (t)->resume = __LINE__; return TASK_YIELDED; case __LINE__:; } while (0)
+#define TASK_WAIT_FRAME(t) do { (t)->resume = __LINE__; return TASK_WAITING; case __LINE__:; } while (0)
+#define TASK_END(t) } (t)->resume = 0; return TASK_DONE
+
+//---------------------------------------------------------------------------------
+// Task Structure
+typedef struct Task {
+    u8 (*step)(struct Task *task);  // Step function (0 = free slot)
+    u16 resume;         // Coroutine resume point (0 = start)
+    u16 counter;        // Scratch state that survives yields
+    void *data;         // Owner data
+    u8 priority;        // TASK_PRIORITY_* (lower first)
+    u8 budget;          // Scanlines this task may use per frame
+    u8 usedLines;       // Scanlines used in the last frame
+    u8 maxLines;        // Worst single-frame use so far
+} Task;
+
+typedef u8 (*TaskStep)(Task *task);
+
+//---------------------------------------------------------------------------------
+// Scheduler State Structure
+typedef struct {
+    Task tasks[TASK_MAX];
+    u8 order[TASK_MAX];         // Task indices sorted by priority
+    u8 count;                   // Entries in order[]
+    u16 frameStartLine;         // V counter when runTasks() started
+    u8 deferred;                // Tasks skipped last frame by the deadline
+} TaskScheduler;
+
+//---------------------------------------------------------------------------------
+// External declarations
+extern TaskScheduler taskScheduler;
+
+//---------------------------------------------------------------------------------
+// Function declarations
+void initTasks(void);
+Task *addTask(TaskStep step, u8 priority, u8 budget, void *data);
+void removeTask(Task *task);
+void runTasks(void);
+u16 readScanline(void);
+
+#endif // TASKS_H
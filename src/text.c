@@ -0,0 +1,278 @@
+/*---------------------------------------------------------------------------------
+
+
+    Chronic Echo - Text Engine Implementation
+    -- WRAM shadow text tilemap with dirty-row DMA and typewriter dialog boxes
+
+
+---------------------------------------------------------------------------------*/
+#include <snes.h>
+
+#include "text.h"
+
+//---------------------------------------------------------------------------------
+// Global text state
+TextLayer textLayer;
+DialogState dialog;
+
+#define TEXT_BLANK_TILE TEXT_TILE_BASE
+
+//---------------------------------------------------------------------------------
+static void markRowDirty(u8 row)
+{
+    if (!textLayer.dirty[row]) {
+        textLayer.dirty[row] = 1;
+        textLayer.dirtyCount++;
+    }
+}
+
+//---------------------------------------------------------------------------------
+// Map entry for an ASCII character (palette 0, no flip)
+static u16 charTile(char c)
+{
+    if ((u8)c < TEXT_FIRST_CHAR || (u8)c > '~') {
+        c = '?';
+    }
+    return TEXT_TILE_BASE + (u8)(c - TEXT_FIRST_CHAR);
+}
+
+//---------------------------------------------------------------------------------
+// Every row starts dirty: VRAM holds whatever the console left there
+void initText(void)
+{
+    u8 row;
+
+    textLayer.dirtyCount = 0;
+    textLayer.flushedBytes = 0;
+    textClear();
+    for (row = 0; row < TEXT_ROWS; row++) {
+        markRowDirty(row);
+    }
+
+    dialog.cursor = 0;
+}
+
+//---------------------------------------------------------------------------------
+// Blank the whole layer; changed rows reach VRAM on the next flushes
+void textClear(void)
+{
+    textClearRows(0, TEXT_ROWS);
+}
+
+//---------------------------------------------------------------------------------
+// Rows that were already blank stay clean, so clearing a screen that held two
+// lines of text costs two rows of DMA rather than the whole map
+void textClearRows(u8 firstRow, u8 rowCount)
+{
+    u16 *entry = &textLayer.map[firstRow << 5];
+    u8 row, x, changed;
+
+    for (row = firstRow; row < firstRow + rowCount && row < TEXT_ROWS; row++) {
+        changed = 0;
+        for (x = 0; x < TEXT_COLUMNS; x++) {
+            if (*entry != TEXT_BLANK_TILE) {
+                *entry = TEXT_BLANK_TILE;
+                changed = 1;
+            }
+            entry++;
+        }
+        if (changed) {
+            markRowDirty(row);
+        }
+    }
+}
+
+//---------------------------------------------------------------------------------
+// Write a string into the shadow map (clipped at the right edge). The row is
+// only marked dirty if a tile actually changed, so redrawing the same text
+// every frame costs no DMA; nothing touches the PPU until textFlush().
+void textDrawString(u8 x, u8 y, const char *text)
+{
+    u16 *entry = &textLayer.map[(y << 5) + x];
+    u16 tile;
+    u8 changed = 0;
+
+    if (y >= TEXT_ROWS) {
+        return;
+    }
+    while (*text && x < TEXT_COLUMNS) {
+        tile = charTile(*text++);
+        if (*entry != tile) {
+            *entry = tile;
+            changed = 1;
+        }
+        entry++;
+        x++;
+    }
+    if (changed) {
+        markRowDirty(y);
+    }
+}
+
+//---------------------------------------------------------------------------------
+// Copy dirty rows to VRAM. Call in VBlank with the DMA bytes left this
+// VBlank. Runs of adjacent dirty rows go out as one DMA; rows past the
+// budget wait for the next call.
+void textFlush(u16 byteBudget)
+{
+    u8 row = 0;
+    u8 budget = byteBudget / TEXT_ROW_BYTES;
+    u8 first;
+
+    textLayer.flushedBytes = 0;
+    while (textLayer.dirtyCount && budget && row < TEXT_ROWS) {
+        if (!textLayer.dirty[row]) {
+            row++;
+            continue;
+        }
+
+        first = row;
+        while (row < TEXT_ROWS && textLayer.dirty[row] && budget) {
+            textLayer.dirty[row] = 0;
+            textLayer.dirtyCount--;
+            budget--;
+            row++;
+        }
+
+        dmaCopyVram((u8 *)&textLayer.map[first << 5], TEXT_MAP_VRAM + (first << 5),
+                    (row - first) * TEXT_ROW_BYTES);
+        textLayer.flushedBytes += (row - first) * TEXT_ROW_BYTES;
+    }
+}
+
+//---------------------------------------------------------------------------------
+// Dialog box
+//---------------------------------------------------------------------------------
+
+#define DIALOG_WIDTH (TEXT_DIALOG_COLUMNS + 2)
+#define DIALOG_HEIGHT (TEXT_DIALOG_LINES + 2)
+
+//---------------------------------------------------------------------------------
+static void putChar(u8 x, u8 y, char c)
+{
+    textLayer.map[(y << 5) + x] = charTile(c);
+    markRowDirty(y);
+}
+
+//---------------------------------------------------------------------------------
+// Border plus empty interior
+static void drawDialogFrame(void)
+{
+    u8 x, y;
+    u8 right = TEXT_DIALOG_LEFT + DIALOG_WIDTH - 1;
+    u8 bottom = TEXT_DIALOG_TOP + DIALOG_HEIGHT - 1;
+
+    for (y = TEXT_DIALOG_TOP; y <= bottom; y++) {
+        for (x = TEXT_DIALOG_LEFT; x <= right; x++) {
+            if (y == TEXT_DIALOG_TOP || y == bottom) {
+                putChar(x, y, (x == TEXT_DIALOG_LEFT || x == right) ? '+' : '-');
+            } else {
+                putChar(x, y, (x == TEXT_DIALOG_LEFT || x == right) ? '|' : ' ');
+            }
+        }
+    }
+}
+
+//---------------------------------------------------------------------------------
+static void clearDialogPage(void)
+{
+    u8 x, y;
+
+    for (y = 1; y <= TEXT_DIALOG_LINES; y++) {
+        for (x = 1; x <= TEXT_DIALOG_COLUMNS; x++) {
+            putChar(TEXT_DIALOG_LEFT + x, TEXT_DIALOG_TOP + y, ' ');
+        }
+    }
+    dialog.column = 0;
+    dialog.line = 0;
+    dialog.pageDone = 0;
+}
+
+//---------------------------------------------------------------------------------
+// Consume one byte of the dialog. Returns 0 once the page is finished.
+static u8 typeNextChar(void)
+{
+    u8 code = *dialog.cursor;
+
+    if (code == TEXT_CODE_END || code == TEXT_CODE_PAGE) {
+        dialog.pageDone = 1;
+        dialog.lastPage = (code == TEXT_CODE_END);
+        if (code == TEXT_CODE_PAGE) {
+            dialog.cursor++;
+        }
+
+        // More marker in the bottom border
+        putChar(TEXT_DIALOG_LEFT + DIALOG_WIDTH - 2, TEXT_DIALOG_TOP + DIALOG_HEIGHT - 1,
+                dialog.lastPage ? '-' : 'v');
+        return 0;
+    }
+
+    dialog.cursor++;
+    if (code == TEXT_CODE_NEWLINE) {
+        dialog.line++;
+        dialog.column = 0;
+    } else if (dialog.line < TEXT_DIALOG_LINES && dialog.column < TEXT_DIALOG_COLUMNS) {
+        putChar(TEXT_DIALOG_LEFT + 1 + dialog.column, TEXT_DIALOG_TOP + 1 + dialog.line, (char)code);
+        dialog.column++;
+    }
+    return 1;
+}
+
+//---------------------------------------------------------------------------------
+// Open a dialog from the bank: u8 count, u8 reserved, u16 offsets[count], text
+void openDialog(u8 id)
+{
+    u8 *bank = (u8 *)&dialogbank;
+
+    if (id >= bank[0]) {
+        return;
+    }
+
+    dialog.cursor = bank + (bank[2 + id * 2] | (bank[3 + id * 2] << 8));
+    dialog.timer = TEXT_DIALOG_TICKS_PER_CHAR;
+    dialog.lastPage = 0;
+    drawDialogFrame();
+    clearDialogPage();
+}
+
+//---------------------------------------------------------------------------------
+// Call once per logic tick while a dialog is open. A finishes the page being
+// typed, then turns the page or closes the box after the last one.
+void updateDialog(u16 currentPadState, u16 previousPadState)
+{
+    u8 pressed = (currentPadState & KEY_A) && !(previousPadState & KEY_A);
+
+    if (!dialog.cursor) {
+        return;
+    }
+
+    if (!dialog.pageDone) {
+        if (pressed) {
+            while (typeNextChar()) {
+            }
+        } else if (--dialog.timer == 0) {
+            dialog.timer = TEXT_DIALOG_TICKS_PER_CHAR;
+            typeNextChar();
+        }
+        return;
+    }
+
+    if (!pressed) {
+        return;
+    }
+    if (dialog.lastPage) {
+        dialog.cursor = 0;
+        textClearRows(TEXT_DIALOG_TOP, DIALOG_HEIGHT);
+        return;
+    }
+
+    // Redraw the border marker and start the next page
+    putChar(TEXT_DIALOG_LEFT + DIALOG_WIDTH - 2, TEXT_DIALOG_TOP + DIALOG_HEIGHT - 1, '-');
+    clearDialogPage();
+}
+
+//---------------------------------------------------------------------------------
+u8 isDialogOpen(void)
+{
+    return dialog.cursor != 0;
+}
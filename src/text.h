@@ -0,0 +1,88 @@
+/*---------------------------------------------------------------------------------
+
+
+    Chronic Echo - Text Engine Header
+    -- WRAM shadow text tilemap with dirty-row DMA and typewriter dialog boxes
+
+
+---------------------------------------------------------------------------------*/
+#ifndef TEXT_H
+#define TEXT_H
+
+#include <snes.h>
+
+//---------------------------------------------------------------------------------
+// Text layer: BG1 map at VRAM 0x6800 (32x32 entries), font tiles loaded by
+// consoleInitText() at 0x3000 = tile 0x100 from the BG1 character base
+#define TEXT_MAP_VRAM 0x6800
+#define TEXT_COLUMNS 32
+#define TEXT_ROWS 32
+#define TEXT_VISIBLE_ROWS 28
+#define TEXT_TILE_BASE 0x0100       // Matches consoleSetTextOffset() in main()
+#define TEXT_FIRST_CHAR ' '
+#define TEXT_ROW_BYTES (TEXT_COLUMNS * 2)
+
+//---------------------------------------------------------------------------------
+// Dialog box (bottom of the screen). Text is wrapped and paged at build time
+// by scripts/gen_dialog.py, which reads these two values from this file.
+#define TEXT_DIALOG_COLUMNS 26
+#define TEXT_DIALOG_LINES 4
+#define TEXT_DIALOG_LEFT 2          // Border column; text starts one column in
+#define TEXT_DIALOG_TOP 21          // Border row; text starts one row down
+#define TEXT_DIALOG_TICKS_PER_CHAR 2
+
+// Dialog bank control bytes
+#define TEXT_CODE_END 0x00
+#define TEXT_CODE_NEWLINE 0x0A
+#define TEXT_CODE_PAGE 0x0C
+
+//---------------------------------------------------------------------------------
+// Dialog ids (order must match assets/text/dialog.txt)
+#define DIALOG_CONTROLS 0
+#define DIALOG_REWIND 1
+#define DIALOG_COUNT 2
+
+//---------------------------------------------------------------------------------
+// Text Layer Structure
+typedef struct {
+    u16 map[TEXT_ROWS * TEXT_COLUMNS];  // Shadow of the BG1 tilemap
+    u8 dirty[TEXT_ROWS];                // Row changed since its last flush?
+    u8 dirtyCount;                      // Rows with dirty set
+    u16 flushedBytes;                   // Bytes DMA'd by the last textFlush()
+} TextLayer;
+
+//---------------------------------------------------------------------------------
+// Dialog State Structure
+typedef struct {
+    u8 *cursor;         // Next byte of the open dialog (0 = closed)
+    u8 column;          // Next text column inside the box
+    u8 line;            // Next text line inside the box
+    u8 timer;           // Ticks until the next character
+    u8 pageDone;        // Page typed out, waiting for A
+    u8 lastPage;        // The finished page ends the dialog
+} DialogState;
+
+//---------------------------------------------------------------------------------
+// External declarations
+extern TextLayer textLayer;
+extern DialogState dialog;
+
+// Wrapped dialog bank (built by scripts/gen_dialog.py)
+extern char dialogbank, dialogbank_end;
+
+//---------------------------------------------------------------------------------
+// Function declarations
+
+// Text layer
+void initText(void);
+void textClear(void);
+void textClearRows(u8 firstRow, u8 rowCount);
+void textDrawString(u8 x, u8 y, const char *text);
+void textFlush(u16 byteBudget);
+
+// Dialog boxes
+void openDialog(u8 id);
+void updateDialog(u16 currentPadState, u16 previousPadState);
+u8 isDialogOpen(void);
+
+#endif // TEXT_H
@@ -11,6 +11,10 @@
 
 #include "time_manipulation.h"
 #include "player.h"
+#include "hdma_effects.h"
+#include "sound.h"
+#include "sprites.h"
+#include "time_scale.h"
 
 //---------------------------------------------------------------------------------
 // Global position history buffer
@@ -128,6 +132,27 @@ void stopRewind(void)
     positionHistory.isRewinding = 0;
 }
 
+//---------------------------------------------------------------------------------
+// Drop a slow-time bubble centred on the player for time energy. Only the
+// entities inside it are slowed: the player and the position history keep
+// running on game ticks, so rewinding is unaffected.
+u8 castTimeBubble(void)
+{
+    s16 x = playerCharacter.x + (PLAYER_WIDTH - TIME_BUBBLE_SIZE) / 2;
+    s16 y = playerCharacter.y + (PLAYER_HEIGHT - TIME_BUBBLE_SIZE) / 2;
+
+    if (playerCharacter.timeEnergy < TIME_BUBBLE_ENERGY_COST) {
+        return 0;  // Not enough time energy
+    }
+    if (addTimeBubble(x, y, TIME_BUBBLE_SIZE, TIME_BUBBLE_SIZE,
+                      TIME_BUBBLE_SCALE, TIME_BUBBLE_TICKS) == TIME_BUBBLE_NONE) {
+        return 0;  // All bubbles in use
+    }
+
+    playerCharacter.timeEnergy -= TIME_BUBBLE_ENERGY_COST;
+    return 1;
+}
+
 //---------------------------------------------------------------------------------
 // Get position entry for a specific frame number
 PositionHistoryEntry* getPositionAtFrame(u16 frameNumber)
@@ -207,17 +232,27 @@ void handleTimeManipulationInput(u16 currentPadState, u16 previousPadState)
     // Check for rewind button press (L button)
     if ((currentPadState & REWIND_BUTTON) && !(previousPadState & REWIND_BUTTON)) {
         // L button was just pressed - attempt to rewind by 1 frame
-        if (canRewindDistance(1)) {
-            rewindByFrames(1);
+        if (canRewindDistance(1) && rewindByFrames(1)) {
+            // Warp distortion runs on HDMA: constant cost while it lasts
+            startTimeWarp();
+            queueSoundEffect(SFX_REWIND_START);
+        } else {
+            queueSoundEffect(SFX_REWIND_FAIL);
+        }
+    }
+
+    // Check for rewind button release - resume recording and end the warp
+    if (!(currentPadState & REWIND_BUTTON) && (previousPadState & REWIND_BUTTON)) {
+        if (positionHistory.isRewinding) {
+            queueSoundEffect(SFX_REWIND_STOP);
         }
-        // Note: No else clause - failed rewinds are silent for now
-        // Could add audio/visual feedback here in future phases
+        stopRewind();
+        stopTimeWarp();
     }
 
-    // Check for fast forward button (R button) - reserved for future feature
-    if ((currentPadState & FAST_FORWARD_BUTTON) && !(previousPadState & FAST_FORWARD_BUTTON)) {
-        // R button pressed - could implement fast forward in future
-        // For now, do nothing
+    // Check for time bubble button press (R button)
+    if ((currentPadState & TIME_BUBBLE_BUTTON) && !(previousPadState & TIME_BUBBLE_BUTTON)) {
+        queueSoundEffect(castTimeBubble() ? SFX_REWIND_START : SFX_REWIND_FAIL);
     }
 
     // Check for rewind button hold (continuous rewind)
@@ -11,16 +11,20 @@
 
 #include <snes.h>
 
+#include "game_loop.h"
+
 //---------------------------------------------------------------------------------
-// Constants
-#define POSITION_HISTORY_SIZE 300  // Store 5 seconds of position history at 60fps
+// Constants (history "frames" are logic ticks: one entry per tick on any region)
+#ifndef POSITION_HISTORY_SIZE
+#define POSITION_HISTORY_SIZE SECONDS_TO_TICKS(5)  // Store 5 seconds of position history
+#endif
 #define REWIND_ENERGY_COST 5       // Time energy cost per rewind frame
-#define MAX_REWIND_DISTANCE 180    // Maximum frames that can be rewound at once
+#define MAX_REWIND_DISTANCE SECONDS_TO_TICKS(3)    // Maximum frames that can be rewound at once
 
 //---------------------------------------------------------------------------------
 // Input Constants
 #define REWIND_BUTTON KEY_L        // L button for time rewind
-#define FAST_FORWARD_BUTTON KEY_R  // R button for fast forward (future feature)
+#define TIME_BUBBLE_BUTTON KEY_R   // R button drops a slow-time bubble
 
 //---------------------------------------------------------------------------------
 // Position History Entry Structure
@@ -59,6 +63,9 @@ u8 rewindToFrame(u16 targetFrame);
 u8 rewindByFrames(u16 frameCount);
 void stopRewind(void);
 
+// Time bubbles
+u8 castTimeBubble(void);
+
 // Input handling
 void handleTimeManipulationInput(u16 currentPadState, u16 previousPadState);
 
@@ -0,0 +1,146 @@
+/*---------------------------------------------------------------------------------
+
+
+    Chronic Echo - Local Time Scale Implementation
+    -- Time bubbles and per-entity 8.8 tick accumulators
+
+
+---------------------------------------------------------------------------------*/
+#include <snes.h>
+#include <string.h>  // For memset
+
+#include "time_scale.h"
+
+//---------------------------------------------------------------------------------
+// Global time bubble set
+TimeBubbleSet timeBubbles;
+
+//---------------------------------------------------------------------------------
+void initTimeBubbles(void)
+{
+    memset(&timeBubbles, 0, sizeof(TimeBubbleSet));
+}
+
+//---------------------------------------------------------------------------------
+// Burst every bubble (leaving the game screen)
+void clearTimeBubbles(void)
+{
+    u8 i;
+    for (i = 0; i < MAX_TIME_BUBBLES; i++) {
+        timeBubbles.bubbles[i].active = 0;
+    }
+    timeBubbles.count = 0;
+    timeBubbles.generation++;
+}
+
+//---------------------------------------------------------------------------------
+// Open a bubble over a rectangle for 'ticks' game ticks (TIME_BUBBLE_FOREVER
+// to keep it). Returns its index, or TIME_BUBBLE_NONE when all are in use.
+u8 addTimeBubble(s16 x, s16 y, u16 width, u16 height, u16 scale, u16 ticks)
+{
+    u8 i;
+    TimeBubble *bubble = timeBubbles.bubbles;
+
+    for (i = 0; i < MAX_TIME_BUBBLES; i++, bubble++) {
+        if (!bubble->active) {
+            bubble->left = x;
+            bubble->top = y;
+            bubble->right = x + width;
+            bubble->bottom = y + height;
+            bubble->scale = scale;
+            bubble->ticksLeft = ticks;
+            bubble->active = 1;
+            timeBubbles.count++;
+            timeBubbles.generation++;
+            return i;
+        }
+    }
+    return TIME_BUBBLE_NONE;
+}
+
+//---------------------------------------------------------------------------------
+void removeTimeBubble(u8 index)
+{
+    if (index >= MAX_TIME_BUBBLES || !timeBubbles.bubbles[index].active) {
+        return;
+    }
+    timeBubbles.bubbles[index].active = 0;
+    timeBubbles.count--;
+    timeBubbles.generation++;
+}
+
+//---------------------------------------------------------------------------------
+// Count bubble lifetimes down; called once per game tick, so bubbles last the
+// same time on NTSC and PAL and replay identically
+void updateTimeBubbles(void)
+{
+    u8 i;
+    TimeBubble *bubble = timeBubbles.bubbles;
+
+    if (timeBubbles.count == 0) {
+        return;
+    }
+    for (i = 0; i < MAX_TIME_BUBBLES; i++, bubble++) {
+        if (bubble->active && bubble->ticksLeft != TIME_BUBBLE_FOREVER) {
+            if (--bubble->ticksLeft == 0) {
+                removeTimeBubble(i);
+            }
+        }
+    }
+}
+
+//---------------------------------------------------------------------------------
+// Scale at a point: the slowest bubble containing it, else TIME_SCALE_NORMAL
+u16 timeScaleAt(s16 x, s16 y)
+{
+    u8 i;
+    u8 inside = 0;
+    u16 scale = TIME_SCALE_NORMAL;
+    TimeBubble *bubble = timeBubbles.bubbles;
+
+    if (timeBubbles.count == 0) {
+        return TIME_SCALE_NORMAL;
+    }
+    for (i = 0; i < MAX_TIME_BUBBLES; i++, bubble++) {
+        if (bubble->active &&
+            x >= bubble->left && x < bubble->right &&
+            y >= bubble->top && y < bubble->bottom) {
+            if (!inside || bubble->scale < scale) {
+                scale = bubble->scale;
+            }
+            inside = 1;
+        }
+    }
+    return scale;
+}
+
+//---------------------------------------------------------------------------------
+// Start an entity at normal speed; its scale is looked up on the first tick
+void resetLocalTime(LocalTime *time)
+{
+    time->scale = TIME_SCALE_NORMAL;
+    time->accum = 0;
+    time->moved = 1;
+}
+
+//---------------------------------------------------------------------------------
+// Advance an entity's clock by one game tick at the point (x, y). Returns
+// how many updates it owes: 0 on the ticks a slowed entity sits out, 1
+// normally, 2 or more inside a faster bubble.
+u8 advanceLocalTime(LocalTime *time, s16 x, s16 y)
+{
+    u8 steps;
+
+    if (time->moved || time->generation != timeBubbles.generation) {
+        time->scale = timeScaleAt(x, y);
+        time->generation = timeBubbles.generation;
+    }
+
+    time->accum += time->scale;
+    steps = time->accum >> 8;
+    time->accum &= 0xFF;
+
+    // The entity moves now, so look the scale up at its new position next tick
+    time->moved = steps;
+    return steps;
+}
@@ -0,0 +1,86 @@
+/*---------------------------------------------------------------------------------
+
+
+    Chronic Echo - Local Time Scale Header
+    -- Time bubbles and per-entity 8.8 tick accumulators
+
+
+---------------------------------------------------------------------------------*/
+#ifndef TIME_SCALE_H
+#define TIME_SCALE_H
+
+#include <snes.h>
+
+#include "game_loop.h"
+
+//---------------------------------------------------------------------------------
+// Time scales: 8.8 fixed-point entity ticks per game tick
+#define TIME_SCALE_FROZEN 0x0000
+#define TIME_SCALE_QUARTER 0x0040
+#define TIME_SCALE_HALF 0x0080
+#define TIME_SCALE_NORMAL 0x0100
+#define TIME_SCALE_DOUBLE 0x0200
+
+//---------------------------------------------------------------------------------
+// Time bubbles: rectangles of slowed (or sped up) time. Where bubbles
+// overlap, the slowest one wins.
+#define MAX_TIME_BUBBLES 4
+#define TIME_BUBBLE_NONE 0xFF
+#define TIME_BUBBLE_FOREVER 0       // ticksLeft value: stays until removed
+
+// Bubble the player casts with TIME_BUBBLE_BUTTON (time_manipulation.c)
+#define TIME_BUBBLE_SIZE 64
+#define TIME_BUBBLE_SCALE TIME_SCALE_QUARTER
+#define TIME_BUBBLE_TICKS SECONDS_TO_TICKS(3)
+#define TIME_BUBBLE_ENERGY_COST 10
+
+//---------------------------------------------------------------------------------
+// Time Bubble Structure
+typedef struct {
+    s16 left;           // Covers left <= x < right, top <= y < bottom
+    s16 top;
+    s16 right;
+    s16 bottom;
+    u16 scale;          // TIME_SCALE_* inside the bubble
+    u16 ticksLeft;      // Game ticks until it bursts, or TIME_BUBBLE_FOREVER
+    u8 active;
+} TimeBubble;
+
+//---------------------------------------------------------------------------------
+// Time Bubble Set. generation changes whenever a bubble appears or bursts,
+// so entities only look their scale up again after that or after moving.
+typedef struct {
+    TimeBubble bubbles[MAX_TIME_BUBBLES];
+    u8 count;           // Active bubbles
+    u8 generation;
+} TimeBubbleSet;
+
+//---------------------------------------------------------------------------------
+// Local Time Structure, embedded in each time-scaled entity
+typedef struct {
+    u16 scale;          // Scale at the entity's position when last looked up
+    u16 accum;          // 8.8 accumulator: fraction of a tick carried over
+    u8 generation;      // timeBubbles.generation of that lookup
+    u8 moved;           // Stepped since the lookup: look the scale up again
+} LocalTime;
+
+// True when an entity is frozen and nothing has changed since: its update
+// can be skipped without calling advanceLocalTime()
+#define LOCAL_TIME_FROZEN(t) ((t)->scale == TIME_SCALE_FROZEN && (t)->generation == timeBubbles.generation)
+
+//---------------------------------------------------------------------------------
+// External declarations
+extern TimeBubbleSet timeBubbles;
+
+//---------------------------------------------------------------------------------
+// Function declarations
+void initTimeBubbles(void);
+void clearTimeBubbles(void);
+u8 addTimeBubble(s16 x, s16 y, u16 width, u16 height, u16 scale, u16 ticks);
+void removeTimeBubble(u8 index);
+void updateTimeBubbles(void);
+u16 timeScaleAt(s16 x, s16 y);
+void resetLocalTime(LocalTime *time);
+u8 advanceLocalTime(LocalTime *time, s16 x, s16 y);
+
+#endif // TIME_SCALE_H
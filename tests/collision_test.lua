@@ -0,0 +1,49 @@
+-- Collision Test for Chronic Echo
+-- Walks the player into walls of room 0 (assets/maps/room0.txt) and checks
+-- the swept movement stops flush against them without tunnelling.
+
+local HOLD_FRAMES = 60
+
+-- Each case: start position, held direction, expected final position
+local CASES = {
+    { name = "Right Border", x = 180, y = 104, pad = {right = true}, expectX = 31 * 8 - 16, expectY = 104 },
+    { name = "Top Border", x = 24, y = 60, pad = {up = true}, expectX = 24, expectY = 8 },
+    { name = "Fence", x = 96, y = 120, pad = {up = true}, expectX = 96, expectY = 9 * 8 },
+    { name = "Fence Gap", x = 120, y = 120, pad = {up = true}, expectX = 120, expectY = 8 },
+    { name = "Pond", x = 80, y = 140, pad = {right = true}, expectX = 14 * 8 - 16, expectY = 140 },
+}
+
+runScenario(function(stop)
+    emu.printHeader("=== Collision Tests ===")
+
+    local caseIndex = 0
+    local frames = 0
+    local current
+
+    local function startCase()
+        caseIndex = caseIndex + 1
+        current = CASES[caseIndex]
+        if not current then
+            stop()
+            return
+        end
+        game.write(game.player, "x", current.x)
+        game.write(game.player, "y", current.y)
+        frames = 0
+    end
+
+    startCase()
+    return function()
+        setPad(current.pad)
+        frames = frames + 1
+        if frames < HOLD_FRAMES then
+            return
+        end
+
+        local x, y = game.player.x, game.player.y
+        local detail = string.format("stopped at (%d, %d), expected (%d, %d)", x, y, current.expectX, current.expectY)
+        emu.logTest(current.name, (x == current.expectX and y == current.expectY) and "pass" or "fail", detail)
+        setPad({})
+        startCase()
+    end
+end)
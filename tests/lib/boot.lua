@@ -0,0 +1,128 @@
+-- Boot Helpers for Chronic Echo tests
+-- Get a test to "in game, fade-in complete" without re-running the intro.
+-- Part of build/lua_prelude.lua, which make test prepends to every test
+-- script along with the game.* accessors.
+--
+--     startFromBootSnapshot(function() ... end)
+--     runScenario(function(stop) ...; return function(frame) ... end end)
+--     setPad({right = true, a = true})     -- controller 1, {} releases
+--
+-- Notes:
+-- - scripts/run_tests.sh boots the ROM once (tests/lib/make_snapshot.lua),
+--   then sets the global BOOT_SNAPSHOT_HEX in front of each test. When it
+--   is set, the state is loaded at the first WaitForVBlank and onReady runs
+--   on the next frame end.
+-- - Without a snapshot (e.g. a test run by hand) the intro is played
+--   through with Start presses instead, so tests behave the same either way.
+-- - Needs SYMBOLS and game (game_memory.lua) defined above it.
+
+local BOOT_TIMEOUT_FRAMES = 900
+local BOOT_FADE_IN_FRAMES = 80   -- Game screen irises in over 32 frames (8 steps of 4)
+
+-- Set controller 1 for the coming frames. Shared by every test script.
+function setPad(buttons)
+    -- Mesen2 takes (input, port); older snes_test builds take (port, input)
+    if not pcall(emu.setInput, buttons, 0) then
+        pcall(emu.setInput, 0, buttons)
+    end
+end
+
+-- Play through the intro and title, then call onReady once the game
+-- screen is fully faded in
+function bootToGame(onReady)
+    local frames = 0
+    local gameFrames = nil
+    local callbackId
+
+    callbackId = emu.addEventCallback(function()
+        frames = frames + 1
+        if gameFrames == nil then
+            -- Tap Start until the first game frame enables the echoes
+            setPad({start = (frames % 20) < 2})
+            if game.echoes and game.echoes.enabled ~= 0 then
+                gameFrames = 0
+            elseif frames >= BOOT_TIMEOUT_FRAMES then
+                print("[FAIL] Boot: game screen not reached")
+                emu.stop()
+            end
+            return
+        end
+
+        setPad({})
+        gameFrames = gameFrames + 1
+        if gameFrames >= BOOT_FADE_IN_FRAMES then
+            emu.removeEventCallback(callbackId, emu.eventType.frameEnd)
+            onReady()
+        end
+    end, emu.eventType.frameEnd)
+end
+
+-- Frame-driven test from the game screen: onStart(stop) runs once the screen
+-- is up and returns onFrame(frame), which is called at every frame end (frame
+-- counts from 1) until the test calls stop(). stop() releases the pad,
+-- removes the callback and ends the run.
+function runScenario(onStart)
+    startFromBootSnapshot(function()
+        local frame = 0
+        local stopped = false
+        local callbackId
+        local onFrame
+
+        local function stop()
+            if stopped then
+                return
+            end
+            stopped = true
+            setPad({})
+            if callbackId then
+                emu.removeEventCallback(callbackId, emu.eventType.frameEnd)
+            end
+            emu.stop()
+        end
+
+        onFrame = onStart(stop)
+        if stopped then
+            return
+        end
+        callbackId = emu.addEventCallback(function()
+            if stopped then
+                return
+            end
+            frame = frame + 1
+            onFrame(frame)
+        end, emu.eventType.frameEnd)
+    end)
+end
+
+local function decodeHex(hex)
+    return (hex:gsub("%x%x", function(byte) return string.char(tonumber(byte, 16)) end))
+end
+
+-- Restore the shared boot snapshot if one was provided, else boot normally
+function startFromBootSnapshot(onReady)
+    if not BOOT_SNAPSHOT_HEX or BOOT_SNAPSHOT_HEX == "" or not SYMBOLS.WaitForVBlank then
+        bootToGame(onReady)
+        return
+    end
+
+    local state = decodeHex(BOOT_SNAPSHOT_HEX)
+    local loaded = false
+    local execId, frameId
+
+    -- Savestates load from inside a CPU callback, at a clean frame boundary
+    execId = emu.addMemoryCallback(function()
+        if not loaded then
+            loaded = true
+            emu.loadSavestate(state)
+        end
+    end, emu.callbackType.exec, SYMBOLS.WaitForVBlank, SYMBOLS.WaitForVBlank)
+
+    frameId = emu.addEventCallback(function()
+        if loaded then
+            emu.removeMemoryCallback(execId, emu.callbackType.exec, SYMBOLS.WaitForVBlank, SYMBOLS.WaitForVBlank)
+            emu.removeEventCallback(frameId, emu.eventType.frameEnd)
+            onReady()
+        end
+    end, emu.eventType.frameEnd)
+end
+
@@ -0,0 +1,149 @@
+-- Game Memory Accessors for Chronic Echo tests
+-- Typed, symbol-resolved reads of the C globals:
+--
+--     game.playerCharacter.timeEnergy
+--     game.positionHistory.count
+--     game.positionHistory.entries[0].x      -- arrays are 0-based, as in C
+--     game.addressOf("playerCharacter", "timeEnergy")
+--
+-- Notes:
+-- - Needs SYMBOLS (scripts/gen_lua_symbols.py) and LAYOUTS/GLOBALS
+--   (scripts/gen_lua_layouts.py) defined above it; the Makefile builds
+--   build/lua_prelude.lua from all three and prepends it to each test.
+-- - Addresses are resolved once per struct view and cached, so a field
+--   read is one table lookup plus one or two emu.read calls.
+-- - game.write(view, field, value) is provided for test setup.
+
+local game = {}
+
+local memType = emu.memType.cpu
+local read = emu.read
+local write = emu.write
+
+local function read16(address)
+    return read(address, memType) | (read(address + 1, memType) << 8)
+end
+
+local readers = {
+    u8 = function(address) return read(address, memType) end,
+    s8 = function(address)
+        local value = read(address, memType)
+        return value >= 0x80 and value - 0x100 or value
+    end,
+    u16 = read16,
+    s16 = function(address)
+        local value = read16(address)
+        return value >= 0x8000 and value - 0x10000 or value
+    end,
+    u32 = function(address) return read16(address) | (read16(address + 2) << 16) end,
+    ptr = function(address) return read16(address) | (read(address + 2, memType) << 16) end,
+}
+readers.s32 = readers.u32
+readers.char = readers.s8
+readers.int = readers.s16
+
+local typeSizes = {u8 = 1, s8 = 1, char = 1, u16 = 2, s16 = 2, int = 2, u32 = 4, s32 = 4, ptr = 4}
+
+local function sizeOf(typeName)
+    return typeSizes[typeName] or (LAYOUTS[typeName] and LAYOUTS[typeName].size) or 2
+end
+
+local viewCache = {}
+local makeStruct
+
+-- Array of typeName elements starting at base (0-based index)
+local function makeArray(base, typeName, count)
+    local key = "a" .. base .. typeName
+    if viewCache[key] then return viewCache[key] end
+
+    local stride = sizeOf(typeName)
+    local reader = readers[typeName]
+    local view = setmetatable({}, {
+        __index = function(_, index)
+            if type(index) ~= "number" or index < 0 or index >= count then
+                return nil
+            end
+            if reader then
+                return reader(base + index * stride)
+            end
+            return makeStruct(base + index * stride, typeName)
+        end,
+        __len = function() return count end,
+    })
+    viewCache[key] = view
+    return view
+end
+
+-- Struct view: field reads go straight to emulator memory
+makeStruct = function(base, typeName)
+    local key = "s" .. base .. typeName
+    if viewCache[key] then return viewCache[key] end
+
+    local fields = LAYOUTS[typeName].fields
+    local view = setmetatable({}, {
+        __index = function(_, name)
+            local field = fields[name]
+            if not field then
+                return nil
+            end
+            local address = base + field[1]
+            if field[3] > 0 then
+                return makeArray(address, field[2], field[3])
+            end
+            local reader = readers[field[2]]
+            if reader then
+                return reader(address)
+            end
+            return makeStruct(address, field[2])
+        end,
+        __newindex = function()
+            error("game memory views are read-only; use game.write()")
+        end,
+    })
+    rawset(view, "__base", base)
+    rawset(view, "__type", typeName)
+    viewCache[key] = view
+    return view
+end
+
+-- Address of a global, or of one of its (top-level) fields
+function game.addressOf(globalName, fieldName)
+    local base = SYMBOLS[globalName]
+    if not base then
+        error("no symbol for " .. globalName)
+    end
+    if fieldName then
+        return base + LAYOUTS[GLOBALS[globalName][1]].fields[fieldName][1]
+    end
+    return base
+end
+
+-- Write a scalar field of a struct view
+function game.write(view, fieldName, value)
+    local field = LAYOUTS[rawget(view, "__type")].fields[fieldName]
+    local address = rawget(view, "__base") + field[1]
+    local size = sizeOf(field[2])
+    for i = 0, size - 1 do
+        write(address + i, (value >> (8 * i)) & 0xFF, memType)
+    end
+end
+
+-- Globals resolve lazily on first use
+setmetatable(game, {
+    __index = function(_, name)
+        local info = GLOBALS[name]
+        local base = SYMBOLS[name]
+        if not info or not base then
+            return nil
+        end
+        local view
+        if info[2] > 0 then
+            view = makeArray(base, info[1], info[2])
+        else
+            view = makeStruct(base, info[1])
+        end
+        rawset(game, name, view)
+        return view
+    end,
+})
+
@@ -0,0 +1,36 @@
+-- Boot Snapshot Generator for scripts/run_tests.sh
+-- Boots to "in game, fade-in complete" and prints the savestate as hex.
+--
+-- Notes:
+-- - Headless Lua cannot write files, so the state goes to stdout as
+--   "SNAPSHOT <hex>" lines followed by "SNAPSHOT_END"; the runner turns
+--   them back into a BOOT_SNAPSHOT_HEX definition.
+-- - The state is taken at WaitForVBlank entry, the same point tests load it.
+
+local HEX_LINE_BYTES = 2048
+
+local function printSnapshot(state)
+    local hex = {}
+    for i = 1, #state do
+        hex[#hex + 1] = string.format("%02x", state:byte(i))
+        if #hex == HEX_LINE_BYTES then
+            print("SNAPSHOT " .. table.concat(hex))
+            hex = {}
+        end
+    end
+    if #hex > 0 then
+        print("SNAPSHOT " .. table.concat(hex))
+    end
+    print("SNAPSHOT_END")
+end
+
+bootToGame(function()
+    local captured = false
+    emu.addMemoryCallback(function()
+        if not captured then
+            captured = true
+            printSnapshot(emu.createSavestate())
+            emu.stop()
+        end
+    end, emu.callbackType.exec, SYMBOLS.WaitForVBlank, SYMBOLS.WaitForVBlank)
+end)
@@ -0,0 +1,53 @@
+-- NPC Flow Field Test for Chronic Echo
+-- Leaves the player standing still and checks every spawned NPC walks the
+-- flow field (src/flow_field.c) to the player's cell around room 0's walls.
+
+local MAX_FRAMES = 900          -- Far corner to centre is ~40 cells at 8 frames each
+local EXPECTED_NPCS = 16        -- NPC_DEFAULT_COUNT
+
+runScenario(function(stop)
+    emu.printHeader("=== NPC Flow Field Tests ===")
+
+    local firstField
+
+    local function activeNpcs()
+        local list = {}
+        for i = 0, #game.npcs - 1 do
+            local npc = game.npcs[i]
+            if npc.active ~= 0 then
+                list[#list + 1] = npc
+            end
+        end
+        return list
+    end
+
+    local function finish(arrived, total, frames)
+        emu.logTest("Spawned", total == EXPECTED_NPCS and "pass" or "fail",
+            string.format("%d active NPCs", total))
+        emu.logTest("Field Built", firstField and "pass" or "fail",
+            string.format("first field after %s frames, %d builds", tostring(firstField), game.flowField.builds))
+        emu.logTest("All Arrived", arrived == total and "pass" or "fail",
+            string.format("%d/%d at the player's cell after %d frames", arrived, total, frames))
+        stop()
+    end
+
+    return function(frames)
+        if not firstField and game.flowField.builds > 0 then
+            firstField = frames
+        end
+
+        local goalX = game.player.x - game.player.x % 8
+        local goalY = game.player.y - game.player.y % 8
+        local list = activeNpcs()
+        local arrived = 0
+        for _, npc in ipairs(list) do
+            if npc.x == goalX and npc.y == goalY then
+                arrived = arrived + 1
+            end
+        end
+
+        if (#list > 0 and arrived == #list) or frames >= MAX_FRAMES then
+            finish(arrived, #list, frames)
+        end
+    end
+end)
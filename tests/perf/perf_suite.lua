@@ -0,0 +1,247 @@
+-- Cycle-count Performance Suite for Chronic Echo
+-- Measures per-frame and per-function CPU cycles for scripted input scenarios.
+--
+-- Notes:
+-- - Not run directly: scripts/perf_check.sh prepends build/lua_prelude.lua
+--   (SYMBOLS, the game memory accessors and bootToGame; Lua file I/O is
+--   blocked headless).
+-- - Frame cost = cycles from WaitForVBlank returning to the next call,
+--   i.e. the work done per frame. The scanline at the call shows how much
+--   of the frame that work used.
+-- - Function cost is inclusive (callees included), measured from the
+--   jsr.l entry to the return address pushed on the stack.
+-- - Results are printed as "PERF <scenario> <metric> <value>" lines for
+--   scripts/perf_check.sh to compare against tests/perf/baseline.txt.
+
+-- Functions on the per-frame hot path
+local HOT_FUNCTIONS = {
+    "updatePlayer",
+    "updateProjectiles",
+    "drawPlayer",
+    "drawProjectiles",
+    "updateNpcs",
+    "drawNpcs",
+    "drawEchoes",
+    "oamAllocCommit",
+    "recordCurrentPosition",
+    "handleTimeManipulationInput",
+    "updateHdmaEffects",
+    "flushSoundQueue",
+    "runTasks",
+}
+
+-- Scripted input scenarios: buttons(frame) returns the pad state
+local SETTLE_FRAMES = 30
+local MEASURE_FRAMES = 120
+local SCENARIOS = {
+    { name = "idle", buttons = function(f) return {} end },
+    { name = "walking", buttons = function(f)
+        if (f // 60) % 2 == 0 then return {right = true} end
+        return {left = true}
+    end },
+    { name = "projectiles_8", buttons = function(f)
+        -- Fire on every other frame (edge-triggered) to keep all 8 in flight
+        return {up = (f < 2), a = (f % 2 == 0)}
+    end },
+    -- Last: letting go of L opens the one-time rewind dialog
+    { name = "rewind_hold", buttons = function(f) return {l = true} end },
+}
+
+local phase = "boot"
+local phaseFrame = 0
+local scenarioIndex = 1
+local failed = false
+
+-- Current measurement accumulators
+local frameStats = nil
+local functionStats = {}
+local pendingReturns = {}     -- return address -> stack of {name, startCycles}
+local returnHooks = {}        -- return addresses that already have a callback
+local workStart = nil
+
+local function printHeader(text)
+    local msg = string.format("=== %s ===", text)
+    print(msg)
+    emu.log(msg)
+end
+
+-- emu.getState() is flat ("cpu.cycleCount") in Mesen2 and nested in older builds
+local function getCpuValue(state, key)
+    local value = state["cpu." .. key]
+    if value == nil and state.cpu then
+        value = state.cpu[key]
+    end
+    return value or 0
+end
+
+local function getPpuValue(state, key)
+    local value = state["ppu." .. key]
+    if value == nil and state.ppu then
+        value = state.ppu[key]
+    end
+    return value or 0
+end
+
+local function cycles()
+    return getCpuValue(emu.getState(), "cycleCount")
+end
+
+local function read8(address)
+    return emu.read(address, emu.memType.cpu)
+end
+
+-- Return address of a jsr.l: PCL, PCH, PBR above S, plus one
+local function returnAddress()
+    local sp = getCpuValue(emu.getState(), "sp")
+    local lo = read8(sp + 1)
+    local hi = read8(sp + 2)
+    local bank = read8(sp + 3)
+    return ((bank * 65536) + (hi * 256) + lo + 1) & 0xFFFFFF
+end
+
+local function resetMeasurement()
+    frameStats = {frames = 0, total = 0, max = 0, scanlineMax = 0}
+    functionStats = {}
+    for _, name in ipairs(HOT_FUNCTIONS) do
+        functionStats[name] = {calls = 0, total = 0}
+    end
+end
+
+local function onReturn(address)
+    local stack = pendingReturns[address]
+    if not stack or #stack == 0 then
+        return
+    end
+    local entry = table.remove(stack)
+    local now = cycles()
+
+    if entry.name == "WaitForVBlank" then
+        workStart = now
+    elseif frameStats and phase == "measure" then
+        local stats = functionStats[entry.name]
+        stats.calls = stats.calls + 1
+        stats.total = stats.total + (now - entry.start)
+    end
+end
+
+local function pushReturn(name)
+    local address = returnAddress()
+    if not pendingReturns[address] then
+        pendingReturns[address] = {}
+    end
+    table.insert(pendingReturns[address], {name = name, start = cycles()})
+
+    -- Call sites are few: hook each return address once and keep it
+    if not returnHooks[address] then
+        returnHooks[address] = true
+        emu.addMemoryCallback(function() onReturn(address) end, emu.callbackType.exec, address, address)
+    end
+end
+
+local function onWaitForVBlank()
+    if phase == "measure" and workStart then
+        local state = emu.getState()
+        local work = getCpuValue(state, "cycleCount") - workStart
+        local scanline = getPpuValue(state, "scanline")
+        frameStats.frames = frameStats.frames + 1
+        frameStats.total = frameStats.total + work
+        if work > frameStats.max then frameStats.max = work end
+        if scanline > frameStats.scanlineMax then frameStats.scanlineMax = scanline end
+    end
+    pushReturn("WaitForVBlank")
+end
+
+local function report(scenario)
+    local frames = math.max(frameStats.frames, 1)
+    print(string.format("PERF %s frame.avg %d", scenario, frameStats.total // frames))
+    print(string.format("PERF %s frame.max %d", scenario, frameStats.max))
+    print(string.format("PERF %s frame.scanline_max %d", scenario, frameStats.scanlineMax))
+    print(string.format("PERF %s arena.high_water %d", scenario, game.arena.highWater))
+    print(string.format("PERF %s arena.failures %d", scenario, game.arena.failures))
+    for _, name in ipairs(HOT_FUNCTIONS) do
+        local stats = functionStats[name]
+        if stats.calls > 0 then
+            print(string.format("PERF %s %s.per_frame %d", scenario, name, stats.total // frames))
+            print(string.format("PERF %s %s.per_call %d", scenario, name, stats.total // stats.calls))
+        end
+    end
+end
+
+local function finish()
+    if failed then
+        print("PERF_STATUS fail")
+    else
+        print("PERF_STATUS done")
+    end
+    emu.stop()
+end
+
+-- Install entry hooks from the generated symbol table
+local function installHooks()
+    if not SYMBOLS or not SYMBOLS.WaitForVBlank then
+        print("PERF_ERROR symbol table missing WaitForVBlank (run through scripts/perf_check.sh)")
+        failed = true
+        return false
+    end
+
+    emu.addMemoryCallback(onWaitForVBlank, emu.callbackType.exec, SYMBOLS.WaitForVBlank, SYMBOLS.WaitForVBlank)
+    for _, name in ipairs(HOT_FUNCTIONS) do
+        local address = SYMBOLS[name]
+        if address then
+            emu.addMemoryCallback(function() pushReturn(name) end, emu.callbackType.exec, address, address)
+        else
+            print("PERF_WARN no symbol for " .. name)
+        end
+    end
+    return true
+end
+
+local function onInputPolled()
+    -- bootToGame() drives the pad until the game screen is up
+    if phase == "settle" or phase == "measure" then
+        setPad(SCENARIOS[scenarioIndex].buttons(phaseFrame))
+    end
+end
+
+local function onFrameEnd()
+    phaseFrame = phaseFrame + 1
+
+    if phase == "settle" and phaseFrame >= SETTLE_FRAMES then
+        resetMeasurement()
+        phase = "measure"
+        phaseFrame = 0
+    elseif phase == "measure" and phaseFrame >= MEASURE_FRAMES then
+        report(SCENARIOS[scenarioIndex].name)
+        scenarioIndex = scenarioIndex + 1
+        if scenarioIndex > #SCENARIOS then
+            finish()
+            return
+        end
+        printHeader("Scenario: " .. SCENARIOS[scenarioIndex].name)
+        phase = "settle"
+        phaseFrame = 0
+    end
+end
+
+printHeader("Chronic Echo Performance Suite")
+if installHooks() then
+    if emu.eventType.inputPolled then
+        emu.addEventCallback(onInputPolled, emu.eventType.inputPolled)
+    end
+    emu.addEventCallback(function()
+        if not emu.eventType.inputPolled then
+            onInputPolled()
+        end
+        onFrameEnd()
+    end, emu.eventType.frameEnd)
+
+    -- Intro and title first (bootToGame stops the run if the game screen
+    -- never comes up, so PERF_STATUS is missing and perf_check.sh fails)
+    bootToGame(function()
+        printHeader("Scenario: " .. SCENARIOS[scenarioIndex].name)
+        phase = "settle"
+        phaseFrame = 0
+    end)
+else
+    finish()
+end
@@ -0,0 +1,140 @@
+-- Golden Replay Driver for Chronic Echo
+-- Plays an input script from the game screen and prints one hash line per
+-- frame for scripts/replay_check.sh to compare against the golden stream.
+--
+-- Notes:
+-- - Not run directly: replay_check.sh prepends build/lua_prelude.lua and
+--   defines REPLAY_SCRIPT (the .input file as a string) and
+--   REPLAY_FB_INTERVAL (hash the framebuffer every N frames, 0 = never).
+-- - Output: "HASHCOLS frame <region>..." once, then
+--   "HASH <frame> <hash>..." per frame, then "REPLAY_STATUS done".
+-- - Hash is 32-bit FNV-1a over each region's bytes, read 16 bits at a time
+--   where the emulator allows it.
+-- - SRAM is cleared first so a battery save from an earlier run cannot
+--   change the starting state.
+
+local SRAM_BASE = 0x700000
+local SRAM_SIZE = 0x2000
+local FNV_OFFSET = 0x811C9DC5
+local FNV_PRIME = 0x01000193
+
+local memType = emu.memType.cpu
+local read = emu.read
+local readWord = emu.readWord
+
+-- Regions hashed every frame, from the generated layouts
+local REGIONS = {}
+local function addRegion(name)
+    local info = GLOBALS[name]
+    local size = LAYOUTS[info[1]].size * math.max(info[2], 1)
+    REGIONS[#REGIONS + 1] = {name = name, address = game.addressOf(name), size = size}
+end
+addRegion("player")
+addRegion("playerCharacter")
+addRegion("positionHistory")
+addRegion("projectiles")
+addRegion("timeBubbles")
+
+local function hashRegion(address, size)
+    local h = FNV_OFFSET
+    if readWord then
+        local last = address + size - 2
+        for a = address, last, 2 do
+            h = ((h ~ readWord(a, memType)) * FNV_PRIME) & 0xFFFFFFFF
+        end
+        if size % 2 == 1 then
+            h = ((h ~ read(address + size - 1, memType)) * FNV_PRIME) & 0xFFFFFFFF
+        end
+    else
+        for a = address, address + size - 1 do
+            h = ((h ~ read(a, memType)) * FNV_PRIME) & 0xFFFFFFFF
+        end
+    end
+    return h
+end
+
+local function hashFramebuffer()
+    local ok, buffer = pcall(emu.getScreenBuffer)
+    if not ok or not buffer then
+        return 0
+    end
+    local h = FNV_OFFSET
+    for i = 1, #buffer do
+        h = ((h ~ (buffer[i] & 0xFFFFFFFF)) * FNV_PRIME) & 0xFFFFFFFF
+    end
+    return h
+end
+
+-- Expand "<frames> <buttons>" lines into one pad table per frame
+local function parseScript(text)
+    local frames = {}
+    for line in text:gmatch("[^\n]+") do
+        local count, buttons = line:match("^%s*(%d+)%s+(%S+)")
+        if count then
+            local pad = {}
+            if buttons ~= "-" then
+                for button in buttons:gmatch("[^,]+") do
+                    pad[button] = true
+                end
+            end
+            for _ = 1, tonumber(count) do
+                frames[#frames + 1] = pad
+            end
+        end
+    end
+    return frames
+end
+
+local function clearSaveRam()
+    for address = SRAM_BASE, SRAM_BASE + SRAM_SIZE - 1 do
+        emu.write(address, 0, memType)
+    end
+end
+
+local inputs = parseScript(REPLAY_SCRIPT or "")
+local fbInterval = REPLAY_FB_INTERVAL or 0
+
+local function startReplay()
+    local frame = 0
+    local columns = {"HASHCOLS frame"}
+    for _, region in ipairs(REGIONS) do
+        columns[#columns + 1] = region.name
+    end
+    if fbInterval > 0 then
+        columns[#columns + 1] = "framebuffer"
+    end
+    print(table.concat(columns, " "))
+
+    local function applyInput()
+        setPad(inputs[frame + 1] or {})
+    end
+
+    if emu.eventType.inputPolled then
+        emu.addEventCallback(applyInput, emu.eventType.inputPolled)
+    end
+
+    applyInput()
+    emu.addEventCallback(function()
+        local line = {"HASH", tostring(frame)}
+        for _, region in ipairs(REGIONS) do
+            line[#line + 1] = string.format("%08x", hashRegion(region.address, region.size))
+        end
+        if fbInterval > 0 then
+            line[#line + 1] = (frame % fbInterval == 0) and string.format("%08x", hashFramebuffer()) or "-"
+        end
+        print(table.concat(line, " "))
+
+        frame = frame + 1
+        if frame >= #inputs then
+            print("REPLAY_STATUS done")
+            emu.stop()
+            return
+        end
+        if not emu.eventType.inputPolled then
+            applyInput()
+        end
+    end, emu.eventType.frameEnd)
+end
+
+clearSaveRam()
+bootToGame(startReplay)
@@ -0,0 +1,138 @@
+-- Time Bubble Test for Chronic Echo
+-- Casts a slow-time bubble with R, fires a projectile out of it with A and
+-- checks the projectile moves at the bubble's quarter speed
+-- (src/time_scale.c), waits for the bubble to burst, then fires again and
+-- checks the new projectile moves at full speed.
+
+local SAMPLE_FRAMES = 16        -- Full speed would cover 16 * PROJECTILE_SPEED
+local PROJECTILE_SPEED = 4
+local MAX_PROJECTILES = 8
+local BUBBLE_TICKS = 180        -- TIME_BUBBLE_TICKS (3 s at 60 Hz)
+local ENERGY_COST = 10          -- TIME_BUBBLE_ENERGY_COST
+local MAX_FRAMES = BUBBLE_TICKS + 60 + SAMPLE_FRAMES
+
+-- Follows one projectile slot from when it becomes active: distance covered
+-- and frames elapsed, up to SAMPLE_FRAMES or until it leaves the screen
+local function newSample(slot)
+    return {slot = slot, elapsed = 0, distance = 0}
+end
+
+local function updateSample(sample)
+    local projectile = game.projectiles[sample.slot]
+    if projectile.active == 0 then
+        return true
+    end
+    if not sample.startX then
+        sample.startX, sample.startY = projectile.x, projectile.y
+        return false
+    end
+    sample.elapsed = sample.elapsed + 1
+    sample.distance = math.abs(projectile.x - sample.startX) + math.abs(projectile.y - sample.startY)
+    return sample.elapsed >= SAMPLE_FRAMES
+end
+
+-- First slot that is active now but was not in 'before'
+local function newlyActive(before)
+    for i = 0, MAX_PROJECTILES - 1 do
+        if game.projectiles[i].active ~= 0 and not before[i] then
+            return i
+        end
+    end
+    return nil
+end
+
+local function activeSlots()
+    local slots = {}
+    for i = 0, MAX_PROJECTILES - 1 do
+        slots[i] = game.projectiles[i].active ~= 0
+    end
+    return slots
+end
+
+runScenario(function(stop)
+    emu.printHeader("=== Time Bubble Tests ===")
+
+    local energyBefore = game.playerCharacter.timeEnergy
+    local slowed, full             -- Samples in and after the bubble
+    local slowedDone, fullDone
+    local fullFireFrame, activeBeforeFull
+
+    local function finish()
+        if not slowed then
+            emu.logTest("Projectile Slowed", "fail", "no projectile was fired")
+        end
+        if not full then
+            emu.logTest("Projectile Full Speed", "fail", "no projectile was fired after the burst")
+        end
+        stop()
+    end
+
+    return function(frames)
+
+        -- Frame 1: press R; frame 3: press A; released in between. After
+        -- the burst, A is pressed once more.
+        if frames == 1 then
+            setPad({r = true})
+        elseif frames == 3 then
+            emu.logTest("Bubble Cast", game.timeBubbles.count == 1 and "pass" or "fail",
+                string.format("%d bubbles", game.timeBubbles.count))
+            emu.logTest("Energy Spent", energyBefore - game.playerCharacter.timeEnergy == ENERGY_COST
+                and "pass" or "fail",
+                string.format("time energy %d -> %d", energyBefore, game.playerCharacter.timeEnergy))
+            setPad({a = true})
+        elseif frames == fullFireFrame then
+            setPad({a = true})
+        else
+            setPad({})
+        end
+
+        -- Inside the bubble: one projectile step per 4 ticks, give or take
+        -- one step for the phase of the accumulator
+        if not slowed and frames > 3 then
+            local slot = newlyActive({})
+            if slot then
+                slowed = newSample(slot)
+            end
+        elseif slowed and not slowedDone and updateSample(slowed) then
+            slowedDone = true
+            local low = math.max(slowed.elapsed // 4 - 1, 0) * PROJECTILE_SPEED
+            local high = (slowed.elapsed // 4 + 1) * PROJECTILE_SPEED
+            emu.logTest("Projectile Slowed",
+                (slowed.distance > 0 and slowed.distance >= low and slowed.distance <= high) and "pass" or "fail",
+                string.format("moved %d px in %d frames (expected %d-%d, full speed %d)",
+                    slowed.distance, slowed.elapsed, low, high, slowed.elapsed * PROJECTILE_SPEED))
+        end
+
+        -- Once the bubble has burst, fire again (with A released first)
+        if slowedDone and not fullFireFrame and game.timeBubbles.count == 0 then
+            emu.logTest("Bubble Burst", "pass", string.format("burst after %d frames", frames))
+            fullFireFrame = frames + 2
+            activeBeforeFull = activeSlots()
+        end
+
+        -- Outside any bubble: one step every tick
+        if fullFireFrame and frames > fullFireFrame and not full then
+            local slot = newlyActive(activeBeforeFull)
+            if slot then
+                full = newSample(slot)
+            end
+        elseif full and not fullDone and updateSample(full) then
+            fullDone = true
+            local low = math.max(full.elapsed - 1, 0) * PROJECTILE_SPEED
+            local high = full.elapsed * PROJECTILE_SPEED
+            emu.logTest("Projectile Full Speed",
+                (full.distance > 0 and full.distance >= low and full.distance <= high) and "pass" or "fail",
+                string.format("moved %d px in %d frames (expected %d-%d)", full.distance, full.elapsed, low, high))
+        end
+
+        if fullDone then
+            finish()
+        elseif frames >= MAX_FRAMES then
+            if not fullFireFrame then
+                emu.logTest("Bubble Burst", "fail",
+                    string.format("%d bubbles left after %d frames", game.timeBubbles.count, frames))
+            end
+            finish()
+        end
+    end
+end)
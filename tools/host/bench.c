@@ -0,0 +1,198 @@
+/*---------------------------------------------------------------------------------
+
+
+    Chronic Echo - Host Microbenchmarks
+    -- Game logic compiled natively and timed with the host clock
+
+
+---------------------------------------------------------------------------------*/
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <snes.h>
+
+#include "player.h"
+#include "time_manipulation.h"
+
+//---------------------------------------------------------------------------------
+// Benchmark Structure
+typedef struct {
+    const char *name;
+    void (*setup)(void);
+    u32 (*run)(u32 iterations);   // Returns a value folded into benchSink
+    u32 iterations;               // At scale 1
+} Benchmark;
+
+//---------------------------------------------------------------------------------
+// Results go here so the optimizer cannot drop the work
+static volatile u32 benchSink;
+
+//---------------------------------------------------------------------------------
+static double nowMs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+//---------------------------------------------------------------------------------
+// Fill the history until it wraps, as after a few seconds of play
+static void setupFullHistory(void)
+{
+    u32 i;
+
+    initPlayerCharacter();
+    initPositionHistory();
+    for (i = 0; i < POSITION_HISTORY_SIZE + POSITION_HISTORY_SIZE / 2; i++) {
+        recordCurrentPosition((s16)(i & 0xFF), (s16)(i % 224));
+    }
+}
+
+//---------------------------------------------------------------------------------
+static void setupCharacter(void)
+{
+    initPlayerCharacter();
+}
+
+//---------------------------------------------------------------------------------
+static u32 benchRecordPosition(u32 iterations)
+{
+    u32 i;
+
+    initPositionHistory();
+    for (i = 0; i < iterations; i++) {
+        recordCurrentPosition((s16)(i & 0xFF), (s16)(i % 224));
+    }
+    return positionHistory.head;
+}
+
+//---------------------------------------------------------------------------------
+// Best case: the frame just recorded
+static u32 benchLookupNewest(u32 iterations)
+{
+    u16 frame = getNewestFrame();
+    u32 found = 0;
+    u32 i;
+
+    for (i = 0; i < iterations; i++) {
+        found += getPositionAtFrame(frame) != 0;
+    }
+    return found;
+}
+
+//---------------------------------------------------------------------------------
+// Worst case: the oldest frame still in the buffer
+static u32 benchLookupOldest(u32 iterations)
+{
+    u16 frame = getOldestFrame();
+    u32 found = 0;
+    u32 i;
+
+    for (i = 0; i < iterations; i++) {
+        found += getPositionAtFrame(frame) != 0;
+    }
+    return found;
+}
+
+//---------------------------------------------------------------------------------
+// Every rewind distance the game allows, in rotation
+static u32 benchRewind(u32 iterations)
+{
+    u16 limit = positionHistory.count < MAX_REWIND_DISTANCE ? positionHistory.count : MAX_REWIND_DISTANCE;
+    u32 done = 0;
+    u32 i;
+
+    for (i = 0; i < iterations; i++) {
+        playerCharacter.timeEnergy = MAX_REWIND_DISTANCE * REWIND_ENERGY_COST;
+        done += rewindByFrames((u16)(1 + i % limit));
+        stopRewind();
+    }
+    return done;
+}
+
+//---------------------------------------------------------------------------------
+// Single items across all types; a full stack is emptied and refilled
+static u32 benchAddItem(u32 iterations)
+{
+    u32 added = 0;
+    u32 i;
+    u8 type;
+
+    for (i = 0; i < iterations; i++) {
+        type = (u8)(ITEM_POTION + i % (ITEM_TYPE_COUNT - 1));
+        if (addItemToCharacterInventory(type, 1)) {
+            added++;
+        } else {
+            removeItemFromCharacterInventory(findCharacterInventorySlot(type), getCharacterItemCount(type));
+        }
+    }
+    return added;
+}
+
+//---------------------------------------------------------------------------------
+// A large experience award from level 1 runs the level-up loop to completion
+static u32 benchLevelUp(u32 iterations)
+{
+    u32 levels = 0;
+    u32 i;
+
+    for (i = 0; i < iterations; i++) {
+        initPlayerCharacter();
+        playerCharacter.experience = 60000;
+        updatePlayerCharacterStats();
+        levels += playerCharacter.level;
+    }
+    return levels;
+}
+
+//---------------------------------------------------------------------------------
+static const Benchmark benchmarks[] = {
+    { "recordCurrentPosition",        setupCharacter,   benchRecordPosition, 5000000 },
+    { "getPositionAtFrame/newest",    setupFullHistory, benchLookupNewest,   5000000 },
+    { "getPositionAtFrame/oldest",    setupFullHistory, benchLookupOldest,     50000 },
+    { "rewindByFrames",               setupFullHistory, benchRewind,          200000 },
+    { "addItemToCharacterInventory",  setupCharacter,   benchAddItem,        5000000 },
+    { "levelUp/loop",                 setupCharacter,   benchLevelUp,         500000 },
+};
+
+#define BENCHMARK_COUNT (sizeof(benchmarks) / sizeof(benchmarks[0]))
+
+//---------------------------------------------------------------------------------
+// Usage: bench [label] [scale]
+int main(int argc, char **argv)
+{
+    const char *label = argc > 1 ? argv[1] : "default";
+    double scale = argc > 2 ? atof(argv[2]) : 1.0;
+    double start, elapsed;
+    u32 iterations;
+    unsigned i;
+
+    if (scale <= 0.0) {
+        scale = 1.0;
+    }
+
+    printf("bench: %s (POSITION_HISTORY_SIZE=%d, MAX_REWIND_DISTANCE=%d)\n",
+           label, POSITION_HISTORY_SIZE, MAX_REWIND_DISTANCE);
+    printf("%-30s %10s %12s %12s\n", "benchmark", "ops", "total ms", "ns/op");
+
+    for (i = 0; i < BENCHMARK_COUNT; i++) {
+        iterations = (u32)(benchmarks[i].iterations * scale);
+        if (iterations == 0) {
+            iterations = 1;
+        }
+
+        benchmarks[i].setup();
+        start = nowMs();
+        benchSink += benchmarks[i].run(iterations);
+        elapsed = nowMs() - start;
+
+        printf("%-30s %10u %12.3f %12.2f\n", benchmarks[i].name, iterations,
+               elapsed, elapsed * 1000000.0 / iterations);
+    }
+
+    return 0;
+}
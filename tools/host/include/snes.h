@@ -0,0 +1,38 @@
+/*---------------------------------------------------------------------------------
+
+
+    Chronic Echo - Host Stub for <snes.h>
+    -- pvsneslib types only, so game logic compiles natively for benchmarks
+
+
+---------------------------------------------------------------------------------*/
+#ifndef HOST_SNES_H
+#define HOST_SNES_H
+
+//---------------------------------------------------------------------------------
+// pvsneslib integer types (sized as on the 65816, not the host int)
+typedef unsigned char u8;
+typedef signed char s8;
+typedef unsigned short u16;
+typedef signed short s16;
+typedef unsigned int u32;
+typedef signed int s32;
+typedef volatile unsigned char vuint8;
+typedef volatile unsigned short vuint16;
+
+//---------------------------------------------------------------------------------
+// Pad bits used by the input constants in game headers
+#define KEY_A 0x0080
+#define KEY_B 0x8000
+#define KEY_X 0x0040
+#define KEY_Y 0x4000
+#define KEY_L 0x0020
+#define KEY_R 0x0010
+#define KEY_START 0x1000
+#define KEY_SELECT 0x2000
+#define KEY_UP 0x0800
+#define KEY_DOWN 0x0400
+#define KEY_LEFT 0x0200
+#define KEY_RIGHT 0x0100
+
+#endif // HOST_SNES_H
@@ -0,0 +1,30 @@
+/*---------------------------------------------------------------------------------
+
+
+    Chronic Echo - Host Stubs
+    -- No-op replacements for hardware modules called by game logic
+
+
+---------------------------------------------------------------------------------*/
+#include <snes.h>
+
+#include "hdma_effects.h"
+#include "sound.h"
+
+//---------------------------------------------------------------------------------
+// HDMA (time_manipulation.c starts/stops the warp)
+void startTimeWarp(void)
+{
+}
+
+void stopTimeWarp(void)
+{
+}
+
+//---------------------------------------------------------------------------------
+// Sound queue
+u8 queueSoundEffect(u8 effect)
+{
+    (void)effect;
+    return 1;
+}